@@ -3,6 +3,7 @@
  * \author Kathryn D. Huff
  */
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -18,6 +19,7 @@
 #include "LumpedNuclide.h"
 #include "MixedCellNuclide.h"
 #include "OneDimPPMNuclide.h"
+#include "RadialFVNuclide.h"
 #include "StubNuclide.h"
 #include "BookKeeper.h"
 #include "Logger.h"
@@ -37,6 +39,7 @@ string Component::nuclide_type_names_[] = {
   "LumpedNuclide",
   "MixedCellNuclide",
   "OneDimPPMNuclide",
+  "RadialFVNuclide",
   "StubNuclide", 
 };
 
@@ -45,22 +48,48 @@ table_ptr Component::gr_contaminant_table_ = table_ptr(new Table("gen_repo_conta
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Component::Component() :
+  template_id_(-1),
   name_(""),
   type_(LAST_EBS),
   thermal_model_(StubThermal::create()),
   nuclide_model_(StubNuclide::create()),
   mat_table_(),
   parent_(),
+  nuclide_daughters_current_(false),
   temp_(0),
   temp_lim_(373),
-  tox_lim_(10) {
+  tox_lim_(10),
+  peak_outer_temp_(0),
+  peak_inner_temp_(0),
+  occupied_length_(0),
+  geom_shared_(false) {
 
-  set_geom(GeometryPtr(new Geometry()));
+  set_geom(Geometry::share(new Geometry()));
   comp_hist_ = CompHistory();
   mass_hist_ = MassHistory();
 
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Component::Component(const ComponentPtr& src) :
+  template_id_(-1),
+  name_(""),
+  type_(LAST_EBS),
+  mat_table_(),
+  parent_(),
+  nuclide_daughters_current_(false),
+  temp_(0),
+  temp_lim_(373),
+  tox_lim_(10),
+  peak_outer_temp_(0),
+  peak_inner_temp_(0),
+  occupied_length_(0),
+  geom_shared_(false) {
+
+  // the geometry and models all come from the template
+  copy(src);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Component::~Component(){ // @TODO is there anything to delete? Make This virtual? 
 }
@@ -85,6 +114,7 @@ void Component::init(string name, ComponentType type, string mat,
     NuclideModelPtr nuclide_model){
 
   ID_=nextID_++;
+  template_id_=ID_;
   
   name_ = name;
   type_ = type;
@@ -111,14 +141,15 @@ void Component::init(string name, ComponentType type, string mat,
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Component::copy(const ComponentPtr& src){
   ID_=nextID_++;
+  template_id_=src->template_id_;
 
   set_name(src->name());
   set_type(src->type());
   set_mat_table(src->mat_table());
 
-  // warning, you are currently copying the centroid as well. 
-  // does this object lay on top of the one being copied?
-  set_geom(src->geom()->copy(src->geom(),src->centroid()));
+  // the geometry is the template's until this is placed, like the models'
+  set_geom(src->geom());
+  geom_shared_ = true;
 
   if ( !(src->thermal_model()) ){
     string err = "The " ;
@@ -153,7 +184,7 @@ void Component::copy(const ComponentPtr& src){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void Component::print(){
-  std::deque<mat_rsrc_ptr> waste_list=wastes();
+  const std::deque<mat_rsrc_ptr>& waste_list=wastes();
   LOG(LEV_DEBUG2,"GRComp") << "Component: " << shared_from_this()->name();
   LOG(LEV_DEBUG2,"GRComp") << "Contains Materials:";
   for(int i=0; i< waste_list.size() ; i++){
@@ -192,28 +223,43 @@ void Component::updateContaminantTable(int the_time){
   if(!gr_contaminant_table_->defined()){
     defineContaminantTable();
   }
-  // get the vec_hist
-  std::pair<IsoVector, double> vec_pair = nuclide_model()->vec_hist(the_time);
-  CompMapPtr comp = vec_pair.first.comp();
-  double mass = vec_pair.second;
-  // iterate over the vec_hist IsoVector
-  std::map<int, double>::iterator entry;
-
+  // bring the histories up to the_time, then read them in place
+  double mass = nuclide_model()->contained_mass(the_time);
+  const VecHist& vec_hist = nuclide_model()->vec_hist();
+  const ConcHist& conc_hist = nuclide_model()->conc_hist();
   row a_row;
   a_row.push_back(std::make_pair( "CompID", ID()));
   a_row.push_back(std::make_pair( "Time", the_time));
   a_row.push_back(std::make_pair( "IsoID", 92235));
   a_row.push_back(std::make_pair( "MassKG", 0));
   a_row.push_back(std::make_pair( "AvailConc", 0));
-  for( entry=comp->begin(); entry!=comp->end(); ++entry ){
-    a_row[2] = std::make_pair( "IsoID", (*entry).first);
-    a_row[3] = std::make_pair( "MassKG", (*entry).second*mass);
-    a_row[4] = std::make_pair( "AvailConc", nuclide_model()->conc_hist(the_time, (*entry).first));
-
+  if( vec_hist.empty() ){
     gr_contaminant_table_->addRow(a_row);
+    return;
+  }
+  const double* fracs = vec_hist.row(the_time);
+  if( fracs == NULL ){
+    return;
+  }
+  const std::vector<Iso>& isos = vec_hist.isos();
+  for(size_t j=0; j < isos.size(); ++j){
+    if( !VecHist::absent(fracs[j]) ){
+      a_row[2] = std::make_pair( "IsoID", isos[j]);
+      a_row[3] = std::make_pair( "MassKG", fracs[j]*mass);
+      a_row[4] = std::make_pair( "AvailConc", conc_hist.at(the_time, isos[j]));
+      gr_contaminant_table_->addRow(a_row);
+    }
   }
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+table_ptr Component::contaminant_table(){
+  if(!gr_contaminant_table_->defined()){
+    defineContaminantTable();
+  }
+  return gr_contaminant_table_;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Component::absorb(mat_rsrc_ptr mat_to_add){
   try{
@@ -251,6 +297,11 @@ void Component::transportNuclides(int the_time){
 ComponentPtr Component::load(ComponentType type, ComponentPtr to_load) {
   to_load->set_parent(ComponentPtr(shared_from_this()));
   daughters_.push_back(to_load);
+  nuclide_daughters_current_ = false;
+  // only a buffer is filled along its length
+  if( type_ == BUFFER ){
+    occupied_length_ += to_load->geom()->length();
+  }
   return shared_from_this();
 }
 
@@ -258,14 +309,9 @@ ComponentPtr Component::load(ComponentType type, ComponentPtr to_load) {
 bool Component::isFull() {
   // @TODO imperative, add better logic here 
   bool to_ret;
-  double wp_len;
-  std::vector<ComponentPtr>::iterator it;
   switch(type()) {
     case BUFFER : 
-      for(it=daughters_.begin(); it!=daughters_.end(); ++it){
-        wp_len += (*it)->geom()->length();
-      }
-      to_ret = (wp_len >= geom()->length());
+      to_ret = (occupied_length_ >= geom()->length());
       break;
     default : 
       to_ret=true;
@@ -275,6 +321,20 @@ bool Component::isFull() {
   return to_ret;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Length Component::remaining_capacity() {
+  Length to_ret;
+  switch(type()) {
+    case BUFFER : 
+      to_ret = max(0.0, geom()->length() - occupied_length_);
+      break;
+    default : 
+      to_ret = 0;
+      break;
+  }
+  return to_ret;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentType Component::type(){return type_;}
 
@@ -350,14 +410,15 @@ ThermalModelPtr Component::thermal_model(QueryEngine* qe){
   ThermalModelPtr toRet;
 
   string model_name = qe->getElementName();;
+  QueryEngine* input = qe->queryElement(model_name);
   
   switch(thermalEnum(model_name))
   {
     case LUMPED_THERMAL:
-      toRet = ThermalModelPtr(LumpedThermal::create(qe));
+      toRet = ThermalModelPtr(LumpedThermal::create(input));
       break;
     case STUB_THERMAL:
-      toRet = ThermalModelPtr(StubThermal::create(qe));
+      toRet = ThermalModelPtr(StubThermal::create(input));
       break;
     default:
       throw CycException("Unknown thermal model enum value encountered."); 
@@ -386,6 +447,9 @@ NuclideModelPtr Component::nuclide_model(QueryEngine* qe){
     case ONEDIMPPM_NUCLIDE:
       toRet = NuclideModelPtr(OneDimPPMNuclide::create(input));
       break;
+    case RADIALFV_NUCLIDE:
+      toRet = NuclideModelPtr(RadialFVNuclide::create(input));
+      break;
     case STUB_NUCLIDE:
       toRet = NuclideModelPtr(StubNuclide::create(input));
       break;
@@ -403,15 +467,14 @@ ThermalModelPtr Component::copyThermalModel(ThermalModelPtr src){
   switch( src->type() )
   {
     case LUMPED_THERMAL:
-      toRet = ThermalModelPtr(LumpedThermal::create());
+      toRet = LumpedThermal::create(*boost::dynamic_pointer_cast<LumpedThermal>(src));
       break;
     case STUB_THERMAL:
-      toRet = ThermalModelPtr(StubThermal::create());
+      toRet = StubThermal::create(*boost::dynamic_pointer_cast<StubThermal>(src));
       break;
     default:
       throw CycException("Unknown thermal model enum value encountered when copying."); 
   }      
-  toRet->copy(src);
   toRet->set_mat_table(mat_table());
   return toRet;
 }
@@ -422,36 +485,42 @@ NuclideModelPtr Component::copyNuclideModel(NuclideModelPtr src){
   switch(src->type())
   {
     case DEGRATE_NUCLIDE:
-      toRet = NuclideModelPtr(DegRateNuclide::create());
+      toRet = DegRateNuclide::create(*boost::dynamic_pointer_cast<DegRateNuclide>(src));
       break;
     case LUMPED_NUCLIDE:
-      toRet = NuclideModelPtr(LumpedNuclide::create());
+      toRet = LumpedNuclide::create(*boost::dynamic_pointer_cast<LumpedNuclide>(src));
       break;
     case MIXEDCELL_NUCLIDE:
-      toRet = NuclideModelPtr(MixedCellNuclide::create());
+      toRet = MixedCellNuclide::create(*boost::dynamic_pointer_cast<MixedCellNuclide>(src));
       break;
     case ONEDIMPPM_NUCLIDE:
-      toRet = NuclideModelPtr(OneDimPPMNuclide::create());
+      toRet = OneDimPPMNuclide::create(*boost::dynamic_pointer_cast<OneDimPPMNuclide>(src));
+      break;
+    case RADIALFV_NUCLIDE:
+      toRet = RadialFVNuclide::create(*boost::dynamic_pointer_cast<RadialFVNuclide>(src));
       break;
     case STUB_NUCLIDE:
-      toRet = NuclideModelPtr(StubNuclide::create());
+      toRet = StubNuclide::create(*boost::dynamic_pointer_cast<StubNuclide>(src));
       break;
     default:
       throw CycException("Unknown nuclide model enum value encountered when copying."); 
   }      
-  toRet->copy(*src);
   toRet->set_mat_table(mat_table());
   return toRet;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-const std::vector<NuclideModelPtr> Component::nuclide_daughters(){
-  std::vector<NuclideModelPtr> to_ret;
-  std::vector<ComponentPtr>::iterator daughter;
-  for( daughter = daughters_.begin(); daughter!=daughters_.end(); ++daughter){
-    to_ret.push_back((*daughter)->nuclide_model());
+const std::vector<NuclideModelPtr>& Component::nuclide_daughters(){
+  if( !nuclide_daughters_current_ ){
+    nuclide_daughters_.clear();
+    nuclide_daughters_.reserve(daughters_.size());
+    std::vector<ComponentPtr>::const_iterator daughter;
+    for( daughter = daughters_.begin(); daughter!=daughters_.end(); ++daughter){
+      nuclide_daughters_.push_back((*daughter)->nuclide_model());
+    }
+    nuclide_daughters_current_ = true;
   }
-  return to_ret;
+  return nuclide_daughters_;
 }
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Component::defineComponentsTable(){
@@ -504,7 +573,7 @@ void Component::addComponentToTable(ComponentPtr comp){
 const int Component::ID(){return ID_;}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-const std::string Component::name(){return name_;} 
+const std::string& Component::name(){return name_;} 
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void Component::set_mat_table(std::string mat){
@@ -519,14 +588,11 @@ void Component::set_mat_table(MatDataTablePtr mat_table){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const MatDataTablePtr Component::mat_table(){return mat_table_;} 
 
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-const std::vector<ComponentPtr> Component::daughters(){return daughters_;}
-
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ComponentPtr Component::parent(){return parent_;}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-const deque<mat_rsrc_ptr> Component::wastes(){return nuclide_model()->wastes();}
+const deque<mat_rsrc_ptr>& Component::wastes(){return nuclide_model()->wastes();}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const Temp Component::temp_lim(){return temp_lim_;}
@@ -541,6 +607,16 @@ const Temp Component::peak_temp(BoundaryType type) {
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const Temp Component::temp(){return temp_;}
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void Component::set_temp(Temp temp){
+  temp_ = temp;
+  peak_outer_temp_ = max(peak_outer_temp_, temp);
+  peak_inner_temp_ = max(peak_inner_temp_, temp);
+  if ( thermal_model_ ) {
+    thermal_model_->set_temp(temp);
+  }
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 const Radius Component::inner_radius(){return geom_->inner_radius();}
 
@@ -567,6 +643,16 @@ ThermalModelPtr Component::thermal_model(){return thermal_model_;}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void Component::setPlacement(point_t centroid, double length){
+  // a buffer keeps the length its daughters occupy
+  if( parent_ && parent_->type() == BUFFER ){
+    parent_->occupied_length_ += length - geom_->length();
+  }
+  if( geom_shared_ ){
+    set_geom(geom_->copy(geom_, centroid));
+    thermal_model_->set_geom(geom_);
+    nuclide_model_->set_geom(geom_);
+    geom_shared_ = false;
+  }
   geom_->set_centroid(centroid);
   geom_->set_length(length); 
 };
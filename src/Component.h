@@ -14,6 +14,7 @@
 #include "ThermalModel.h"
 #include "NuclideModel.h"
 #include "Geometry.h"
+#include "PoolAlloc.h"
 
 /*!
 A map for storing the composition history of a material.
@@ -56,7 +57,8 @@ typedef boost::shared_ptr<Component> ComponentPtr;
    information passing concerning fluxes and other boundary conditions 
    can be passed in and out of them.
  */
-class Component : public boost::enable_shared_from_this<Component> {
+class Component : public boost::enable_shared_from_this<Component>, 
+  public PoolAlloc<Component> {
 
 public:
   /**
@@ -64,6 +66,21 @@ public:
    */
   Component();
 
+  /**
+     Creates an empty component, allocated from the component pool.
+   */
+  static ComponentPtr create(){ return share(new Component()); };
+
+  /**
+     Creates a component as a copy of a template, allocated from the 
+     component pool. Unlike the default constructor followed by copy(), no 
+     default models or geometry are made only to be replaced.
+
+     @param src the template component to copy
+   */
+  static ComponentPtr create(const ComponentPtr& src){ 
+    return share(new Component(src)); };
+
   /** 
      Default destructor does nothing.
    */
@@ -106,13 +123,20 @@ public:
   /**
      Defines the gen_repo_contaminant_table_
     */
-  void defineContaminantTable();
+  static void defineContaminantTable();
 
   /**
      Updates the gen_repo_contaminant_table_ for this component.
+
+     @param the_time the timestep to record
     */
   void updateContaminantTable(int the_time);
 
+  /**
+     Returns the gen_repo_contaminant_table_, defining it if it isn't yet.
+    */
+  static table_ptr contaminant_table();
+
   /**
      Absorbs the contents of the given Material into this Component.
      
@@ -161,6 +185,17 @@ public:
    */
   bool isFull() ;
 
+  /**
+     Reports the length left along a buffer for more waste packages. Other 
+     components hold only what they are loaded with, and have none. 
+
+     @return the length not yet occupied by daughters [m]
+   */
+  Length remaining_capacity();
+
+  /// the length occupied by the daughters of this buffer [m]
+  const Length occupied_length() const {return occupied_length_;};
+
   /**
      Returns the ComponentType of this component (WF, WP, etc.)
      
@@ -226,9 +261,10 @@ public:
   NuclideModelPtr copyNuclideModel(NuclideModelPtr src);
 
   /**
-     Returns the nuclide models of each daughter component.
+     Returns the nuclide models of each daughter component. The list is 
+     kept until a daughter is loaded or given another nuclide model.
      */
-  const std::vector<NuclideModelPtr> nuclide_daughters();
+  const std::vector<NuclideModelPtr>& nuclide_daughters();
 
   /**
      This table will hold information about the component templates 
@@ -249,6 +285,14 @@ public:
    */
   const int ID();
 
+  /**
+     get the ID of the template this component was copied from. A component 
+     initialized from input is its own template.
+     
+     @return template_id_
+   */
+  const int template_id(){return template_id_;};
+
   /**
      set the Name
 
@@ -261,7 +305,7 @@ public:
      
      @return name_
    */
-  const std::string name();
+  const std::string& name();
 
   /**
      set the material type that this component is made of (clay, salt, glass, etc.)
@@ -291,7 +335,7 @@ public:
      
      @return components
    */
-  const std::vector<ComponentPtr> daughters();
+  const std::vector<ComponentPtr>& daughters() const {return daughters_;};
 
   /**
      get the parent component 
@@ -305,7 +349,7 @@ public:
      
      @return wastes
    */
-  const std::deque<mat_rsrc_ptr> wastes();
+  const std::deque<mat_rsrc_ptr>& wastes();
 
   /**
      get the maximum Temperature this object allows at its boundaries 
@@ -337,6 +381,14 @@ public:
    */
   const Temp temp();
 
+  /**
+     set the Temperature, which is taken to be homogeneous in the component, 
+     and passes it on to the thermal model
+     
+     @param temp the temperature [K]
+   */
+  void set_temp(Temp temp);
+
   /**
      get the inner radius of the object
      
@@ -379,7 +431,12 @@ public:
   /**
      sets the nuclide model to the src nuclide model
    */
-  void set_nuclide_model(const NuclideModelPtr& src){ nuclide_model_ = NuclideModelPtr(src);};
+  void set_nuclide_model(const NuclideModelPtr& src){ 
+    nuclide_model_ = NuclideModelPtr(src);
+    if( parent_ ){
+      parent_->nuclide_daughters_current_ = false;
+    }
+  };
 
   /**
      gets the pointer to the thermal model being used in this component
@@ -389,9 +446,13 @@ public:
   ThermalModelPtr thermal_model();
 
   /**
-     sets the thermal model to the src thermal model
+     sets the thermal model to the src thermal model, which takes on the 
+     temperature limit of this component
    */
-  void set_thermal_model(const ThermalModelPtr& src){ thermal_model_ = ThermalModelPtr(src);};
+  void set_thermal_model(const ThermalModelPtr& src){ 
+    thermal_model_ = ThermalModelPtr(src);
+    thermal_model_->set_temp_lim(temp_lim_);
+  };
 
   /**
      set the parent component 
@@ -401,7 +462,8 @@ public:
   void set_parent(ComponentPtr parent){parent_ = parent;};
 
   /**
-     set the placement of the object
+     set the placement of the object. A component copied from a template 
+     first gets a geometry of its own, which its models then share.
      
      @param centroid is the centroid position vector
      @param length is the length of the object 
@@ -409,11 +471,24 @@ public:
   void setPlacement(point_t centroid, double length);
 
 protected:
+  /**
+     Constructs a component as a copy of a template, without any default 
+     models or geometry. Use create(src).
+
+     @param src the template component to copy
+   */
+  explicit Component(const ComponentPtr& src);
+
   /** 
      The serial number for this Component.
    */
   int ID_;
 
+  /** 
+     The serial number of the template Component this one was copied from.
+   */
+  int template_id_;
+
   /**
      Stores the next available component ID
    */
@@ -468,6 +543,15 @@ protected:
    */
   std::vector<ComponentPtr> daughters_;
 
+  /**
+     The nuclide models of the daughter components, in the order of 
+     daughters_
+   */
+  std::vector<NuclideModelPtr> nuclide_daughters_;
+
+  /// false if nuclide_daughters_ must be made again
+  bool nuclide_daughters_current_;
+
   /**
      The name of this component, a string
    */
@@ -508,6 +592,18 @@ protected:
    */
   Temp peak_inner_temp_;
 
+  /**
+     The total length of the daughters of a buffer, kept as they are loaded 
+     and placed
+   */
+  Length occupied_length_;
+
+  /**
+     True while the geometry is the template's, shared rather than copied, 
+     until the component is placed
+   */
+  bool geom_shared_;
+
   /**
      The peak tox achieved  
    */
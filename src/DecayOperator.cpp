@@ -0,0 +1,338 @@
+/*! \file DecayOperator.cpp
+    \brief Implements the DecayOperator class used by the Generic Repository
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <sstream>
+#include <boost/filesystem.hpp>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "SqliteDb.h"
+#include "DecayOperator.h"
+
+using namespace std;
+
+// a month, the length of a timestep
+const double DecayOperator::SECS_PER_TIMESTEP = 365.25*24*3600/12;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DecayOperator::DecayOperator(){
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DecayOperatorPtr DecayOperator::load(string file_path){
+  DecayOperatorPtr to_ret = DecayOperatorPtr(new DecayOperator());
+  boost::system::error_code ec;
+  if( !boost::filesystem::exists(file_path, ec) ){
+    string err = "Decay is on, but there is no database at " + file_path + ".";
+    LOG(LEV_ERROR,"GRDecay") << err;
+    throw CycException(err);
+  }
+  SqliteDb db(file_path);
+  bool found;
+  {
+    SqliteCursor cursor(db, 
+        "SELECT name FROM sqlite_master WHERE type='table' AND name='decay'");
+    found = cursor.next();
+  }
+  if( !found ){
+    string err = "Decay is on, but the database at " + file_path 
+      + " has no decay table.";
+    LOG(LEV_ERROR,"GRDecay") << err;
+    throw CycException(err);
+  }
+  SqliteCursor cursor(db, 
+      "SELECT parent, daughter, half_life, branch_ratio FROM decay");
+  while( cursor.next() ){
+    to_ret->addLink(cursor.getInt(0), cursor.getDouble(2), 
+        cursor.getInt(1), cursor.getDouble(3));
+  }
+  LOG(LEV_DEBUG2,"GRDecay") << "Loaded the decay data of " << to_ret->n_isos()
+    << " isotopes.";
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DecayOperator::addLink(Iso parent, double half_life, Iso daughter, 
+    double branch_ratio){
+  if( !(half_life > 0) || half_life == numeric_limits<double>::infinity() ||
+      !(branch_ratio > 0) || branch_ratio > 1 ){
+    stringstream msg_ss;
+    msg_ss << "The decay of " << parent << " needs a positive, finite half "
+      << "life and a branching ratio between 0 and 1. The values provided "
+      << "were " << half_life << " and " << branch_ratio << ".";
+    LOG(LEV_ERROR,"GRDecay") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+
+  boost::mutex::scoped_lock lock(mutex_);
+  int p = index(parent);
+  double lambda = log(2.0)/half_life;
+  if( lambda_[p] != 0 && fabs(lambda_[p] - lambda) > 1e-9*lambda ){
+    stringstream msg_ss;
+    msg_ss << "The decay links of " << parent << " have different half lives.";
+    LOG(LEV_ERROR,"GRDecay") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+  lambda_[p] = lambda;
+  if( daughter != 0 ){
+    int d = index(daughter);
+    daughters_[p].push_back(make_pair(d, branch_ratio));
+  }
+  // the propagators are out of date
+  cache_.clear();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int DecayOperator::index(Iso tope){
+  map<Iso, int>::iterator found = index_.find(tope);
+  if( found != index_.end() ){
+    return found->second;
+  }
+  int i = isos_.size();
+  isos_.push_back(tope);
+  index_.insert(make_pair(tope, i));
+  lambda_.push_back(0);
+  daughters_.push_back(vector<pair<int, double> >());
+  return i;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int DecayOperator::n_cached(){
+  boost::mutex::scoped_lock lock(mutex_);
+  return cache_.size();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DecayOperator::PropagatorPtr DecayOperator::propagator(int dt){
+  boost::mutex::scoped_lock lock(mutex_);
+  map<int, PropagatorPtr>::iterator found = cache_.find(dt);
+  if( found != cache_.end() ){
+    return found->second;
+  }
+  PropagatorPtr to_ret = compute(dt);
+  cache_.insert(make_pair(dt, to_ret));
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<vector<int> > DecayOperator::chains() const {
+  int n = isos_.size();
+
+  // the chains are the connected parts of the links
+  vector<int> root(n);
+  for(int i=0; i < n; ++i){
+    root[i] = i;
+  }
+  for(int p=0; p < n; ++p){
+    for(size_t k=0; k < daughters_[p].size(); ++k){
+      int a = p;
+      int b = daughters_[p][k].first;
+      while( root[a] != a ){ a = root[a]; }
+      while( root[b] != b ){ b = root[b]; }
+      root[max(a, b)] = min(a, b);
+    }
+  }
+
+  // order each chain parents first
+  vector<int> n_parents(n, 0);
+  for(int p=0; p < n; ++p){
+    for(size_t k=0; k < daughters_[p].size(); ++k){
+      ++n_parents[daughters_[p][k].first];
+    }
+  }
+  map<int, vector<int> > by_root;
+  deque<int> ready;
+  for(int i=0; i < n; ++i){
+    if( n_parents[i] == 0 ){
+      ready.push_back(i);
+    }
+  }
+  int n_ordered = 0;
+  while( !ready.empty() ){
+    int i = ready.front();
+    ready.pop_front();
+    int r = i;
+    while( root[r] != r ){ r = root[r]; }
+    by_root[r].push_back(i);
+    ++n_ordered;
+    for(size_t k=0; k < daughters_[i].size(); ++k){
+      int d = daughters_[i][k].first;
+      if( --n_parents[d] == 0 ){
+        ready.push_back(d);
+      }
+    }
+  }
+  if( n_ordered < n ){
+    string msg = "The decay links form a cycle.";
+    LOG(LEV_ERROR,"GRDecay") << msg;
+    throw CycException(msg);
+  }
+
+  vector<vector<int> > to_ret;
+  map<int, vector<int> >::iterator it;
+  for(it = by_root.begin(); it != by_root.end(); ++it){
+    to_ret.push_back(it->second);
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DecayOperator::PropagatorPtr DecayOperator::compute(int dt) const {
+  int n = isos_.size();
+  double t = dt*SECS_PER_TIMESTEP;
+  vector<vector<pair<int, double> > > rows(n);
+
+  vector<vector<int> > all_chains = chains();
+  vector<int> pos(n);
+  for(size_t c=0; c < all_chains.size(); ++c){
+    const vector<int>& chain = all_chains[c];
+    int b = chain.size();
+    for(int r=0; r < b; ++r){
+      pos[chain[r]] = r;
+    }
+
+    // the generator of the chain over the step, lower triangular
+    vector<double> A(b*b, 0);
+    for(int r=0; r < b; ++r){
+      int p = chain[r];
+      A[r*b + r] = -lambda_[p]*t;
+      for(size_t k=0; k < daughters_[p].size(); ++k){
+        int d = pos[daughters_[p][k].first];
+        A[d*b + r] += daughters_[p][k].second*lambda_[p]*t;
+      }
+    }
+
+    // scale it until a short taylor series converges
+    double norm = 0;
+    for(int r=0; r < b; ++r){
+      double sum = 0;
+      for(int k=0; k < b; ++k){
+        sum += fabs(A[r*b + k]);
+      }
+      norm = max(norm, sum);
+    }
+    int s = 0;
+    while( norm > 0.5 ){
+      norm /= 2;
+      ++s;
+    }
+    for(int k=0; k < b*b; ++k){
+      A[k] = ldexp(A[k], -s);
+    }
+
+    vector<double> E(b*b, 0), term(b*b, 0), tmp(b*b);
+    for(int r=0; r < b; ++r){
+      E[r*b + r] = 1;
+      term[r*b + r] = 1;
+    }
+    for(int order=1; order <= 16; ++order){
+      fill(tmp.begin(), tmp.end(), 0.0);
+      // both are lower triangular, so only k in [c, r] contribute
+      for(int r=0; r < b; ++r){
+        for(int k=0; k <= r; ++k){
+          double a = term[r*b + k];
+          if( a == 0 ){
+            continue;
+          }
+          for(int col=0; col <= k; ++col){
+            tmp[r*b + col] += a*A[k*b + col];
+          }
+        }
+      }
+      for(int k=0; k < b*b; ++k){
+        term[k] = tmp[k]/order;
+        E[k] += term[k];
+      }
+    }
+
+    // and square it back
+    for(int sq=0; sq < s; ++sq){
+      fill(tmp.begin(), tmp.end(), 0.0);
+      for(int r=0; r < b; ++r){
+        for(int k=0; k <= r; ++k){
+          double a = E[r*b + k];
+          if( a == 0 ){
+            continue;
+          }
+          for(int col=0; col <= k; ++col){
+            tmp[r*b + col] += a*E[k*b + col];
+          }
+        }
+      }
+      E.swap(tmp);
+    }
+
+    for(int r=0; r < b; ++r){
+      for(int col=0; col <= r; ++col){
+        double val = E[r*b + col];
+        if( val > 0 ){
+          rows[chain[r]].push_back(make_pair(chain[col], val));
+        }
+      }
+    }
+  }
+
+  boost::shared_ptr<Propagator> to_ret = 
+    boost::shared_ptr<Propagator>(new Propagator());
+  to_ret->row_start.reserve(n + 1);
+  to_ret->row_start.push_back(0);
+  for(int r=0; r < n; ++r){
+    for(size_t k=0; k < rows[r].size(); ++k){
+      to_ret->cols.push_back(rows[r][k].first);
+      to_ret->vals.push_back(rows[r][k].second);
+    }
+    to_ret->row_start.push_back(to_ret->cols.size());
+  }
+  LOG(LEV_DEBUG2,"GRDecay") << "Computed the decay propagator for a step of " 
+    << dt << " with " << to_ret->vals.size() << " nonzeros.";
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DecayOperator::apply(vector<IsoMassMap>& masses, int dt){
+  for(size_t k=0; k < masses.size(); ++k){
+    apply(masses[k], dt);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DecayOperator::apply(IsoMassMap& masses, int dt){
+  int n = isos_.size();
+  if( dt <= 0 || n == 0 || masses.empty() ){
+    return;
+  }
+
+  // only the isotopes with decay data change, stable ones are left as they are
+  vector<double> in(n, 0);
+  bool any = false;
+  IsoMassMap::const_iterator it;
+  for(it = masses.begin(); it != masses.end(); ++it){
+    map<Iso, int>::const_iterator found = index_.find((*it).first);
+    if( found != index_.end() ){
+      in[found->second] = (*it).second;
+      any = any || (*it).second > 0;
+    }
+  }
+  if( !any ){
+    return;
+  }
+
+  PropagatorPtr prop = propagator(dt);
+  for(int i=0; i < n; ++i){
+    double kg = 0;
+    for(int p = prop->row_start[i]; p < prop->row_start[i+1]; ++p){
+      kg += prop->vals[p]*in[prop->cols[p]];
+    }
+    IsoMassMap::iterator found = masses.find(isos_[i]);
+    if( found != masses.end() ){
+      (*found).second = kg;
+    } else if( kg > 0 ){
+      masses.insert(make_pair(isos_[i], kg));
+    }
+  }
+}
@@ -0,0 +1,141 @@
+/*! \file DecayOperator.h
+  \brief Declares the DecayOperator class used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_DECAYOPERATOR_H)
+#define _DECAYOPERATOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "MatTools.h"
+
+/// A shared pointer for the DecayOperator object
+class DecayOperator;
+typedef boost::shared_ptr<DecayOperator> DecayOperatorPtr;
+
+/**
+   @brief DecayOperator decays and ingrows the contents of the components.
+
+   The decay data is a set of parent -> daughter links, each with the half 
+   life of the parent and the branching ratio. The masses m of the 
+   isotopes then obey dm/dt = L m, and over a step dt they become 
+   exp(L dt) m.
+
+   The isotopes are split into independent decay chains, and each chain
+   is ordered parents first, so that L is block lower triangular. The
+   matrix exponential of each block is found by scaling and squaring, and
+   the nonzeros of all of the blocks are kept as one sparse propagator.
+   A propagator is computed the first time a step length is asked for, and
+   kept for every later step of that length.
+
+   The propagator is applied to the composition of each component in 
+   place, so one propagator serves every component for each step length.
+   Isotopes without decay data are stable and left as they are.
+ */
+class DecayOperator {
+public:
+  /// Default constructor, decays nothing until links are added
+  DecayOperator();
+
+  /**
+     Loads the decay links from the decay table of a database, with the 
+     columns parent, daughter, half_life [s] and branch_ratio. A daughter 
+     of 0 means the parent decays out of the tracked isotopes. 
+
+     @param file_path the path to the sqlite database
+     @return the operator
+     @throws CycException if there is no database, or it has no decay table
+   */
+  static DecayOperatorPtr load(std::string file_path);
+
+  /**
+     Adds a decay link. A parent may have several, but they must all 
+     have the same half life.
+
+     @param parent the decaying isotope
+     @param half_life the half life of the parent [s]
+     @param daughter the isotope produced, or 0 for none that is tracked
+     @param branch_ratio the fraction of the decays that make the daughter
+     @throws CycRangeException if the half life or ratio are not positive
+   */
+  void addLink(Iso parent, double half_life, Iso daughter, 
+      double branch_ratio);
+
+  /**
+     Decays the masses of every composition over a step, in place.
+
+     @param masses the masses of each of the compositions [kg]
+     @param dt the length of the step [timesteps]
+     @throws CycException if the decay links form a cycle
+   */
+  void apply(std::vector<IsoMassMap>& masses, int dt);
+
+  /**
+     Decays the masses of one composition over a step, in place.
+
+     @param masses the masses of the composition [kg]
+     @param dt the length of the step [timesteps]
+     @throws CycException if the decay links form a cycle
+   */
+  void apply(IsoMassMap& masses, int dt);
+
+  /// returns the isotopes with decay data, in the order they were added
+  const std::vector<Iso>& isos() const {return isos_;};
+
+  /// returns the number of isotopes with decay data, parents or daughters
+  int n_isos() const {return isos_.size();};
+
+  /// returns the number of step lengths with a cached propagator
+  int n_cached();
+
+  /// the length of a timestep [s]
+  static const double SECS_PER_TIMESTEP;
+
+protected:
+  /// a propagator, the nonzeros of exp(L dt) row by row (CSR)
+  struct Propagator {
+    std::vector<int> row_start;
+    std::vector<int> cols;
+    std::vector<double> vals;
+  };
+  typedef boost::shared_ptr<const Propagator> PropagatorPtr;
+
+  /// returns the propagator for a step, computing it on first use
+  PropagatorPtr propagator(int dt);
+
+  /// computes the propagator for a step
+  PropagatorPtr compute(int dt) const;
+
+  /**
+     splits the isotopes into independent chains, each ordered parents 
+     first
+   */
+  std::vector<std::vector<int> > chains() const;
+
+  /// returns the index of an isotope, adding it if it is new
+  int index(Iso tope);
+
+  /// the isotopes with decay data, in the order they were added
+  std::vector<Iso> isos_;
+
+  /// the index of each isotope in isos_
+  std::map<Iso, int> index_;
+
+  /// the decay constant of each isotope, 0 if it is stable [1/s]
+  std::vector<double> lambda_;
+
+  /// the daughters of each isotope and their branching ratios
+  std::vector<std::vector<std::pair<int, double> > > daughters_;
+
+  /// the propagators computed so far, by the length of the step
+  std::map<int, PropagatorPtr> cache_;
+
+  /// guards the cache, and the links once they are in use
+  boost::mutex mutex_;
+};
+
+#endif
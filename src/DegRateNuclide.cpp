@@ -20,12 +20,11 @@ using boost::lexical_cast;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 DegRateNuclide::DegRateNuclide():
-  deg_rate_(0),
-  v_(0),
   tot_deg_(0),
   last_degraded_(0)
 {
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
 
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
@@ -36,12 +35,11 @@ DegRateNuclide::DegRateNuclide():
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 DegRateNuclide::DegRateNuclide(QueryEngine* qe):
-  deg_rate_(0),
-  v_(0),
   tot_deg_(0),
   last_degraded_(0)
 {
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
 
@@ -51,6 +49,15 @@ DegRateNuclide::DegRateNuclide(QueryEngine* qe):
   initModuleMembers(qe);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+DegRateNuclide::DegRateNuclide(const DegRateNuclide& src):
+  tot_deg_(0),
+  last_degraded_(0)
+{
+  last_updated_=0;
+  copy_from(src);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 DegRateNuclide::~DegRateNuclide(){
 }
@@ -65,22 +72,28 @@ void DegRateNuclide::initModuleMembers(QueryEngine* qe){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 NuclideModelPtr DegRateNuclide::copy(const NuclideModel& src){
   const DegRateNuclide* src_ptr = dynamic_cast<const DegRateNuclide*>(&src);
+  copy_from(*src_ptr);
 
-  set_v(src_ptr->v());
-  set_deg_rate(src_ptr->deg_rate());
+  return shared_from_this();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void DegRateNuclide::copy_from(const DegRateNuclide& src){
+  // the parameters are shared, not copied
+  params_ = src.params_;
   set_tot_deg(0);
   set_last_degraded(TI->time());
+  set_last_updated(TI->time());
 
-  // copy the geometry AND the centroid. It should be reset later.
-  set_geom(GeometryPtr(new Geometry()));
-  geom_->copy(src_ptr->geom(), src_ptr->geom()->centroid());
-  update(TI->time());
+  // the geometry is the template's until the component is placed, and the
+  // histories are made by the first update
+  set_geom(src.geom());
 
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  iso_masses_ = IsoMassMap();
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
-
-  return shared_from_this();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -103,7 +116,7 @@ void DegRateNuclide::absorb(mat_rsrc_ptr matToAdd)
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRDRNuc") << "DegRateNuclide is absorbing material: ";
   matToAdd->print();
-  wastes_.push_back(matToAdd);
+  absorb_mat(matToAdd);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -114,7 +127,7 @@ mat_rsrc_ptr DegRateNuclide::extract(const CompMapPtr comp_to_rem, double kg_to_
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRDRNuc") << "DegRateNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
-  mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  mat_rsrc_ptr to_ret = extract_mat(comp_to_rem, kg_to_rem);
   update(TI->time());
   return to_ret;
 }
@@ -127,6 +140,11 @@ void DegRateNuclide::transportNuclides(int the_time){
   update(the_time);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void DegRateNuclide::degrade(int the_time){
+  update_degradation(the_time, deg_rate());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void DegRateNuclide::set_deg_rate(double cur_rate){
   if( cur_rate < 0 || cur_rate > 1 ) {
@@ -138,7 +156,7 @@ void DegRateNuclide::set_deg_rate(double cur_rate){
     LOG(LEV_ERROR,"GRDRNuc") << msg_ss.str();;
     throw CycRangeException(msg_ss.str());
   } else {
-    deg_rate_ = cur_rate;
+    params_.write().deg_rate = cur_rate;
   }
   assert((cur_rate >=0) && (cur_rate <= 1));
 }
@@ -167,48 +185,15 @@ IsoConcMap DegRateNuclide::dirichlet_bc(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ConcGradMap DegRateNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
-  ConcGradMap to_ret;
-
   IsoConcMap c_int = conc_hist(last_degraded());
   Radius r_int = geom_->radial_midpoint();
-  
-  int iso;
-  IsoConcMap::iterator it;
-  for( it=c_int.begin(); it != c_int.end(); ++it){
-    iso = (*it).first;
-    if( c_ext.count(iso) != 0) {  
-      // in both
-      to_ret[iso] = calc_conc_grad(c_ext[iso], c_int[iso]*tot_deg(), r_ext, r_int);
-    } else {  
-      // in c_int_only
-      to_ret[iso] = calc_conc_grad(0, c_int[iso]*tot_deg(), r_ext, r_int);
-    }
-  }
-  for( it=c_ext.begin(); it != c_ext.end(); ++it){
-    iso = (*it).first;
-    if( c_int.count(iso) == 0) { 
-      // in c_ext only
-      to_ret[iso] = calc_conc_grad(c_ext[iso], 0, r_ext, r_int);
-    }
-  }
-
-  return to_ret;
+  return calc_conc_grads(c_ext, c_int, tot_deg(), r_ext, r_int);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoFluxMap DegRateNuclide::cauchy_bc(IsoConcMap c_ext, Radius r_ext){
   // -D dC/dx + v_xC = v_x C
-  IsoFluxMap to_ret;
-  ConcGradMap neumann = neumann_bc(c_ext, r_ext);
-  ConcGradMap::iterator it;
-  Iso iso;
-  Elem elem;
-  for( it = neumann.begin(); it != neumann.end(); ++it){
-    iso = (*it).first;
-    elem = iso/1000;
-    to_ret.insert(make_pair(iso, -mat_table_->D(elem)*(*it).second + v()*shared_from_this()->dirichlet_bc(iso)));
-  }
-  return to_ret;
+  return calc_fluxes(neumann_bcs(c_ext, r_ext), dirichlet_bcs(), v());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -223,26 +208,22 @@ IsoConcMap DegRateNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr> ma
 
   IsoConcMap to_ret;
 
-  pair<IsoVector, double> sum_pair; 
-  sum_pair = vec_hist_[the_time];
-
-  int iso;
-  double conc;
-  if(sum_pair.second != 0 && geom_->volume() != numeric_limits<double>::infinity()) { 
-    double scale = sum_pair.second/geom_->volume();
-    CompMapPtr curr_comp = sum_pair.first.comp();
-    CompMap::const_iterator it;
-    it=(*curr_comp).begin();
-    while(it != (*curr_comp).end() ) {
-      iso = (*it).first;
-      conc = (*it).second;
-      to_ret.insert(make_pair(iso, conc*scale));
-      ++it;
+  // read the summed composition in place
+  const double* fracs = vec_hist_.row(the_time);
+  double mass = vec_hist_.mass(the_time);
+  const vector<Iso>& isos = vec_hist_.isos();
+
+  if(fracs != NULL && mass != 0 && geom_->volume() != numeric_limits<double>::infinity()) { 
+    double scale = mass/geom_->volume();
+    for(size_t j=0; j < isos.size(); ++j){
+      if( !VecHist::absent(fracs[j]) ){
+        to_ret.insert(to_ret.end(), make_pair(isos[j], fracs[j]*scale));
+      }
     }
   } else {
     to_ret[ 92235 ] = 0; 
   }
-  conc_hist_[the_time] = to_ret ;
+  conc_hist_.set(the_time, to_ret);
   return to_ret;
 }
 
@@ -261,13 +242,13 @@ double DegRateNuclide::update_degradation(int the_time, double cur_rate){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void DegRateNuclide::update_vec_hist(int the_time){
-  vec_hist_[ the_time ] = MatTools::sum_mats(wastes_) ;
+  set_vec_hist(the_time);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-void DegRateNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
+void DegRateNuclide::update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters){
   std::map<NuclideModelPtr, std::pair<IsoVector,double> > to_ret;
-  std::vector<NuclideModelPtr>::iterator daughter;
+  std::vector<NuclideModelPtr>::const_iterator daughter;
   std::pair<IsoVector, double> source_term;
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
     source_term = (*daughter)->source_term_bc();
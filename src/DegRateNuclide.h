@@ -13,6 +13,8 @@
 #include <string>
 
 #include "NuclideModel.h"
+#include "PoolAlloc.h"
+#include "SharedParams.h"
 
 /// A shared pointer for the DegRateNuclide object
 class DegRateNuclide;
@@ -33,7 +35,7 @@ typedef boost::shared_ptr<DegRateNuclide> DegRateNuclidePtr;
    However, since the Far Field and the Envrionment do not degrade, these are 
    not well represented by the DegRateNuclide model.
  */
-class DegRateNuclide : public NuclideModel {
+class DegRateNuclide : public NuclideModel, public PoolAlloc<DegRateNuclide> {
   /*----------------------------*/
   /* All NuclideModel classes   */
   /* have the following members */
@@ -51,19 +53,38 @@ private:
    */
   DegRateNuclide(QueryEngine* qe);
 
+  /**
+     Constructs a copy of a template model, sharing its parameters, without 
+     the default geometry made only to be replaced. Use create(src).
+
+     @param src the template model to copy
+   */
+  DegRateNuclide(const DegRateNuclide& src);
+
+  /// sets up this model as a copy of src, for copy() and create(src)
+  void copy_from(const DegRateNuclide& src);
+
 public:
 
   /**
      A constructor for the DegRate Nuclide Model that returns a shared pointer.
     */
-  static DegRateNuclidePtr create(){ return DegRateNuclidePtr(new DegRateNuclide()); };
+  static DegRateNuclidePtr create(){ return share(new DegRateNuclide()); };
 
   /**
      A constructor for the DegRate Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static DegRateNuclidePtr create(QueryEngine* qe){ return DegRateNuclidePtr(new DegRateNuclide(qe)); };
+  static DegRateNuclidePtr create(QueryEngine* qe){ return share(new DegRateNuclide(qe)); };
+
+  /**
+     A constructor for the DegRate Nuclide Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static DegRateNuclidePtr create(const DegRateNuclide& src){ return share(new DegRateNuclide(src)); };
 
   /**
      Virtual destructor deletes datamembers that are object pointers.
@@ -115,6 +136,13 @@ public:
    */
   virtual void transportNuclides(int time);
 
+  /**
+     Degrades the component at the degradation rate, to the time
+
+     @param time the timestep to degrade to
+   */
+  virtual void degrade(int time);
+
   /**
      Returns the nuclide model type
    */
@@ -170,9 +198,9 @@ public:
   /** 
      returns the degradation rate that characterizes this model
    *
-     @return deg_rate_ fraction per year
+     @return the degradation rate, a fraction per year
    */
-  const double deg_rate() const {return deg_rate_;};
+  const double deg_rate() const {return params_->deg_rate;};
 
   /** 
      returns the degradation rate that characterizes this model
@@ -239,23 +267,23 @@ public:
      @param time the timestep at which the nuclides should be transported
      @param daughter nuclide_model of an internal component. there may be many.
      */
-  void update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters); 
+  void update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters); 
 
   /// returns the total degradation of the component
   const double tot_deg() const {return tot_deg_;};
 
   /// sets the total degradation of the component
-  void set_tot_deg(const double tot_deg){tot_deg_=tot_deg;};
+  void set_tot_deg(const double tot_deg){tot_deg_=tot_deg; invalidate_bcs();};
 
   /**
-    Set the advective velocity v_ through this component. [m/s] 
+    Set the advective velocity through this component. [m/s] 
    */
-  void set_v(const double v){v_ = v;};
+  void set_v(const double v){params_.write().v = v; invalidate_bcs();};
 
   /**
     The advective velocity through this component. [m/s] 
    */
-  const double v() const {return v_;};
+  const double v() const {return params_->v;};
 
   /**
     Set the last_degraded_ time [integer timestamp]
@@ -268,15 +296,20 @@ public:
   const int last_degraded() const {return last_degraded_;};
 
 protected:
-  /**
-    The advective velocity through this component [m/s]
-   */
-  double v_;
+  /// the parameters of a DegRateNuclide, which its copies share
+  struct Params {
+    /// Constructor, for the default parameters
+    Params() : v(0), deg_rate(0) {};
 
-  /**
-    The degradation rate that defines this model, fraction per year.
-   */
-  double deg_rate_;
+    /// The advective velocity through this component [m/s]
+    double v;
+
+    /// The degradation rate that defines this model, fraction per year.
+    double deg_rate;
+  };
+
+  /// the parameters, shared with the template until one is set
+  SharedParams<Params> params_;
 
   /// the total fraction that this component has degraded
   double tot_deg_;
@@ -0,0 +1,316 @@
+/*! \file EBSSolver.cpp
+    \brief Implements the EBSSolver class used by the Generic Repository
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <boost/math/constants/constants.hpp>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "Timer.h"
+#include "MatTools.h"
+#include "EBSSolver.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EBSSolver::EBSSolver(double v) :
+  v_(v),
+  dirty_(true),
+  refactor_(true),
+  n_factorizations_(0),
+  time_(0),
+  dt_(0)
+{
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EBSSolver::rebuild(const vector<ComponentPtr>& nodes, 
+    const vector<int>& parents){
+  int n = nodes.size();
+  for(int i=0; i < n; ++i){
+    if( parents[i] >= 0 && parents[i] <= i ){
+      stringstream msg_ss;
+      msg_ss << "The EBSSolver needs each component before its parent, but "
+        << nodes[i]->name() << " comes after its parent.";
+      LOG(LEV_ERROR,"GRSolve") << msg_ss.str();
+      throw CycException(msg_ss.str());
+    }
+  }
+  nodes_ = nodes;
+  parent_ = parents;
+
+  // the geometry of each exchange is fixed once the component is placed
+  double pi = boost::math::constants::pi<double>();
+  double inf = numeric_limits<double>::infinity();
+  area_.assign(n, 0);
+  dist_.assign(n, 0);
+  inv_vol_.assign(n, 0);
+  for(int i=0; i < n; ++i){
+    GeometryPtr geom = nodes_[i]->nuclide_model()->geom();
+    double vol = geom->volume();
+    if( vol > 0 && vol < inf ){
+      inv_vol_[i] = 1/vol;
+    }
+    if( parent_[i] < 0 ){
+      continue;
+    }
+    double area = 2*pi*geom->outer_radius()*geom->length();
+    if( area > 0 && area < inf ){
+      area_[i] = area;
+    }
+    // from the middle of the component to the middle of its parent, or to
+    // its own surface if the parent has no middle
+    Radius r_mid = geom->radial_midpoint();
+    Radius r_mid_p = nodes_[parent_[i]]->nuclide_model()->geom()->radial_midpoint();
+    dist_[i] = (r_mid_p > r_mid && r_mid_p < inf) ? r_mid_p - r_mid : 
+      geom->outer_radius() - r_mid;
+  }
+
+  refactor_ = true;
+  dirty_ = false;
+  LOG(LEV_DEBUG2,"GRSolve") << "Rebuilt the EBSSolver for " << n << " components.";
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EBSSolver::solve(int the_time){
+  int dt = the_time - time_;
+  if( dt > 0 ){
+    // the components degrade first, so that what they release over the 
+    // step is limited by their degradation at the end of it
+    for(size_t i=0; i < nodes_.size(); ++i){
+      NuclideModelPtr model = nodes_[i]->nuclide_model();
+      model->degrade(the_time);
+      model->update(the_time);
+    }
+  }
+  vector<Iso> isos = gatherIsos();
+  if( dt > 0 && !nodes_.empty() && !isos.empty() ){
+    bool new_isos = (isos != isos_);
+    if( new_isos ){
+      isos_.swap(isos);
+    }
+
+    // the contents at the start of the step are the right hand side
+    int n = isos_.size();
+    vector<double> x_old(nodes_.size()*n, 0);
+    for(size_t i=0; i < nodes_.size(); ++i){
+      const IsoMassMap& masses = nodes_[i]->nuclide_model()->iso_masses();
+      IsoMassMap::const_iterator it = masses.begin();
+      for(int j=0; j < n && it != masses.end(); ++j){
+        if( (*it).first == isos_[j] ){
+          x_old[i*n + j] = (*it).second;
+          ++it;
+        }
+      }
+    }
+
+    // the exchange is only refactored for a new tree, step or isotope
+    if( refactor_ || dt != dt_ || new_isos ){
+      factor(dt);
+    }
+    vector<double> x(x_old);
+    correct(x_old, x);
+    substitute(x);
+    redistribute(x_old, x, the_time);
+  }
+
+  for(size_t i=0; i < nodes_.size(); ++i){
+    nodes_[i]->nuclide_model()->update(the_time);
+  }
+  time_ = the_time;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<Iso> EBSSolver::gatherIsos() const {
+  set<Iso> isos;
+  for(size_t i=0; i < nodes_.size(); ++i){
+    const IsoMassMap& masses = nodes_[i]->nuclide_model()->iso_masses();
+    IsoMassMap::const_iterator it;
+    for(it = masses.begin(); it != masses.end(); ++it){
+      isos.insert(isos.end(), (*it).first);
+    }
+  }
+  return vector<Iso>(isos.begin(), isos.end());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+vector<double> EBSSolver::heldBack(const vector<double>& x) const {
+  int N = nodes_.size();
+  int n = isos_.size();
+  double inf = numeric_limits<double>::infinity();
+  vector<double> held(N*n, 0);
+  for(int i=0; i < N; ++i){
+    if( inv_vol_[i] == 0 ){
+      // a sink never gives anything back
+      continue;
+    }
+    // the model's own degradation, sorption and solubility limits set the 
+    // concentration at its boundary
+    const IsoConcMap& bcs = nodes_[i]->nuclide_model()->dirichlet_bcs();
+    for(int j=0; j < n; ++j){
+      double kg = x[i*n + j];
+      if( kg <= 0 ){
+        continue;
+      }
+      IsoConcMap::const_iterator found = bcs.find(isos_[j]);
+      double c = (found == bcs.end()) ? 0 : (*found).second;
+      c = (c > 0 && c < inf) ? c : 0;
+      held[i*n + j] = inv_vol_[i]*kg - c;
+    }
+  }
+  return held;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EBSSolver::correct(const vector<double>& x_old, vector<double>& x) const {
+  int N = nodes_.size();
+  int n = isos_.size();
+  vector<double> held = heldBack(x_old);
+  // what the matrix would move across each boundary from the held back 
+  // concentrations is returned to where it came from
+  for(int i=0; i < N; ++i){
+    int p = parent_[i];
+    if( p < 0 ){
+      continue;
+    }
+    const double* out = &out_[i*n];
+    const double* back = &back_[i*n];
+    const double* h = &held[i*n];
+    const double* h_p = &held[p*n];
+    double* xi = &x[i*n];
+    double* x_p = &x[p*n];
+    for(int j=0; j < n; ++j){
+      double flux = out[j]*h[j] - back[j]*h_p[j];
+      xi[j] += flux;
+      x_p[j] -= flux;
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EBSSolver::factor(int dt){
+  int N = nodes_.size();
+  int n = isos_.size();
+  pivot_.assign(N*n, 1);
+  upper_.assign(N*n, 0);
+  mult_.assign(N*n, 0);
+  out_.assign(N*n, 0);
+  back_.assign(N*n, 0);
+  vector<double> lower(N*n, 0);
+  vector<double> D(n);
+
+  // assemble the exchange of each node with its parent
+  for(int i=0; i < N; ++i){
+    int p = parent_[i];
+    if( p < 0 || area_[i] == 0 ){
+      continue;
+    }
+    MatDataTablePtr mat_table = nodes_[i]->nuclide_model()->mat_table();
+    for(int j=0; j < n; ++j){
+      Elem elem = isos_[j]/1000;
+      D[j] = (mat_table && mat_table->valid(elem)) ? mat_table->D(elem) : 0;
+    }
+    double Q = v_*area_[i];
+    for(int j=0; j < n; ++j){
+      double G = (dist_[i] > 0) ? D[j]*area_[i]/dist_[i] : 0;
+      out_[i*n + j] = dt*(G + Q);
+      back_[i*n + j] = dt*G;
+      double out = out_[i*n + j]*inv_vol_[i];
+      double back = back_[i*n + j]*inv_vol_[p];
+      pivot_[i*n + j] += out;
+      pivot_[p*n + j] += back;
+      upper_[i*n + j] = -back;
+      lower[i*n + j] = -out;
+    }
+  }
+
+  // eliminate daughters first, each into its parent only
+  for(int i=0; i < N; ++i){
+    int p = parent_[i];
+    if( p < 0 ){
+      continue;
+    }
+    const double* l = &lower[i*n];
+    const double* u = &upper_[i*n];
+    const double* d = &pivot_[i*n];
+    double* m = &mult_[i*n];
+    double* d_p = &pivot_[p*n];
+    for(int j=0; j < n; ++j){
+      m[j] = l[j]/d[j];
+      d_p[j] -= m[j]*u[j];
+    }
+  }
+
+  dt_ = dt;
+  refactor_ = false;
+  ++n_factorizations_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EBSSolver::substitute(vector<double>& x) const {
+  int N = nodes_.size();
+  int n = isos_.size();
+  // up the tree
+  for(int i=0; i < N; ++i){
+    int p = parent_[i];
+    if( p < 0 ){
+      continue;
+    }
+    const double* m = &mult_[i*n];
+    const double* xi = &x[i*n];
+    double* x_p = &x[p*n];
+    for(int j=0; j < n; ++j){
+      x_p[j] -= m[j]*xi[j];
+    }
+  }
+  // and back down
+  for(int i=N-1; i >= 0; --i){
+    int p = parent_[i];
+    const double* d = &pivot_[i*n];
+    double* xi = &x[i*n];
+    if( p < 0 ){
+      for(int j=0; j < n; ++j){
+        xi[j] /= d[j];
+      }
+    } else {
+      const double* u = &upper_[i*n];
+      const double* x_p = &x[p*n];
+      for(int j=0; j < n; ++j){
+        xi[j] = (xi[j] - u[j]*x_p[j])/d[j];
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void EBSSolver::redistribute(const vector<double>& x_old, 
+    const vector<double>& x, int the_time) const {
+  int N = nodes_.size();
+  int n = isos_.size();
+  vector<IsoMassMap> gains(N);
+  // take everything that leaves a component before anything arrives, so 
+  // that no component is asked for more than it holds
+  for(int i=0; i < N; ++i){
+    IsoMassMap losses;
+    for(int j=0; j < n; ++j){
+      double delta = max(0.0, x[i*n + j]) - x_old[i*n + j];
+      if( delta < 0 ){
+        losses.insert(losses.end(), make_pair(isos_[j], min(-delta, x_old[i*n + j])));
+      } else if( delta > 0 ){
+        gains[i].insert(gains[i].end(), make_pair(isos_[j], delta));
+      }
+    }
+    if( !losses.empty() ){
+      nodes_[i]->nuclide_model()->extract_isos(losses, the_time);
+    }
+  }
+  for(int i=0; i < N; ++i){
+    if( !gains[i].empty() ){
+      nodes_[i]->nuclide_model()->absorb(MatTools::mass_map_to_mat(gains[i]));
+    }
+  }
+}
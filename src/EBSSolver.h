@@ -0,0 +1,194 @@
+/*! \file EBSSolver.h
+  \brief Declares the EBSSolver class used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_EBSSOLVER_H)
+#define _EBSSOLVER_H
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "Component.h"
+
+/// A shared pointer for the EBSSolver object
+class EBSSolver;
+typedef boost::shared_ptr<EBSSolver> EBSSolverPtr;
+
+/**
+   @brief EBSSolver transports nuclides through the whole EBS at once.
+
+   Rather than each component pulling the source term of its daughters in
+   turn, the mass balance of every component in the tree is assembled into
+   one sparse system per isotope and advanced by one implicit (backward
+   Euler) step, so the step is stable however fast the exchange is.
+
+   Each component is treated as a well mixed compartment of volume V, less
+   what its nuclide model holds back at its boundary. Between a component
+   i and its parent p, the exchange is
+   \f[
+      F_{i \to p} = G_i \left(\frac{M_i}{V_i} - \frac{M_p}{V_p}\right) 
+      + Q_i \frac{M_i}{V_i} - G_i \left(h_i - h_p\right) - Q_i h_i
+   \f]
+   where G = D A / dr is the dispersive conductance through the outer
+   surface A of the component, with the D of the component's material, and
+   Q = v A is the advective discharge, upwinded outward. A component of
+   infinite volume, such as the far field, is a sink. The held back
+   concentration h = M/V - C is the difference between the well mixed
+   concentration and the concentration C that the nuclide model gives at
+   its boundary (its dirichlet bc), once it has degraded to the end of the
+   step. It is zero in a well mixed component, and all of M/V in a waste
+   form that has not degraded. The well mixed terms are implicit, while
+   the held back terms are taken from the contents at the start of the 
+   step and added to the right hand side, so the solubility and sorption 
+   limits are applied explicitly, as a correction outside the matrix.
+
+   The matrix has the sparsity of the component tree, so eliminating the
+   components daughters first (the order of the TockScheduler) produces
+   no fill-in. That order and the geometry of each exchange are the
+   symbolic factorization, kept until emplacement changes the tree. Since
+   the matrix holds only the geometry, the materials and the step, the
+   numeric factorization is kept too, until the tree, the timestep or the
+   isotopes present change, so that each step between emplacements is 
+   only one sweep up the tree and one back down, for all isotopes at once.
+
+   The new contents are moved between the nuclide models by extract_isos
+   and absorb, so that each model keeps its own bookkeeping, and each
+   model is then updated to the new time.
+
+   Each model is degraded to the new time before the step, in place of its
+   transportNuclides, which the solver never calls. So the coupled solve
+   ignores what a model does inside itself: the cells of a RadialFVNuclide
+   and the profile of a OneDimPPMNuclide are not advanced, and a
+   LumpedNuclide's formulation is not used. Only the concentration each
+   model presents at its boundary is kept.
+ */
+class EBSSolver {
+public:
+  /**
+     Constructor.
+
+     @param v the advective velocity through the repository [m/s]
+   */
+  EBSSolver(double v=0);
+
+  /**
+     Rebuilds the symbolic factorization from the component tree.
+
+     @param nodes the components, each before its parent
+     @param parents the index of the parent of each component, or -1
+     @throws CycException if a parent comes before one of its daughters
+   */
+  void rebuild(const std::vector<ComponentPtr>& nodes, 
+      const std::vector<int>& parents);
+
+  /**
+     Advances the contents of every component to the_time in one implicit
+     step, from the time of the last step.
+
+     @param the_time the timestep to advance to
+   */
+  void solve(int the_time);
+
+  /// marks the factorization as out of date with the repository tree
+  void invalidate(){dirty_ = true;};
+
+  /// returns true if the factorization must be rebuilt before a solve
+  bool dirty() const {return dirty_;};
+
+  /// returns the number of components in the system
+  int n_nodes() const {return nodes_.size();};
+
+  /// returns the number of numeric factorizations done so far
+  int n_factorizations() const {return n_factorizations_;};
+
+  /// returns the advective velocity through the repository [m/s]
+  double v() const {return v_;};
+
+protected:
+  /// gathers the isotopes contained anywhere in the tree, sorted
+  std::vector<Iso> gatherIsos() const;
+
+  /**
+     computes the pivots and multipliers of the elimination for the
+     isotopes in isos_ and a step of dt
+   */
+  void factor(int dt);
+
+  /**
+     the concentration each node holds back from its boundary, below the
+     well mixed concentration (nodes_ x isos_), from its nuclide model
+
+     @param x the contents of the nodes (nodes_ x isos_) [kg]
+   */
+  std::vector<double> heldBack(const std::vector<double>& x) const;
+
+  /**
+     adds the exchange of the held back concentrations over the step to the
+     rhs, which the matrix would otherwise move
+
+     @param x_old the contents of the nodes at the start of the step [kg]
+     @param x the rhs (nodes_ x isos_) to correct
+   */
+  void correct(const std::vector<double>& x_old, 
+      std::vector<double>& x) const;
+
+  /// replaces the rhs (nodes_ x isos_) with the solution of the system
+  void substitute(std::vector<double>& x) const;
+
+  /// moves mass between the nuclide models so they contain x at the_time
+  void redistribute(const std::vector<double>& x_old, 
+      const std::vector<double>& x, int the_time) const;
+
+  /// the advective velocity through the repository [m/s]
+  double v_;
+
+  /// true if the factorization must be rebuilt before a solve
+  bool dirty_;
+
+  /// true if the numeric factorization must be redone before a solve
+  bool refactor_;
+
+  /// the number of numeric factorizations done so far
+  int n_factorizations_;
+
+  /// the time of the last step
+  int time_;
+
+  /// the step length of the numeric factorization
+  int dt_;
+
+  /// the components, each before its parent
+  std::vector<ComponentPtr> nodes_;
+
+  /// the index of the parent of each node, or -1
+  std::vector<int> parent_;
+
+  /// the area of the outer surface of each node [m^2]
+  std::vector<double> area_;
+
+  /// the distance over which each node exchanges with its parent [m]
+  std::vector<double> dist_;
+
+  /// the inverse volume of each node, zero if it is a sink [1/m^3]
+  std::vector<double> inv_vol_;
+
+  /// the isotopes of the numeric factorization, sorted
+  std::vector<Iso> isos_;
+
+  /// the outward exchange of each node over the step, dt (G + Q) [m^3]
+  std::vector<double> out_;
+
+  /// the inward exchange of each node over the step, dt G [m^3]
+  std::vector<double> back_;
+
+  /// the pivot of each node and isotope (nodes_ x isos_)
+  std::vector<double> pivot_;
+
+  /// the coupling of each node to its parent (nodes_ x isos_)
+  std::vector<double> upper_;
+
+  /// the elimination multiplier of each node into its parent (nodes_ x isos_)
+  std::vector<double> mult_;
+};
+
+#endif
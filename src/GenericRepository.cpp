@@ -6,6 +6,9 @@
 #include <string>
 #include <deque>
 #include <vector>
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
 
 #include "GenericResource.h"
 #include "CycException.h"
@@ -61,10 +64,15 @@ GenericRepository::GenericRepository() {
   inventory_ = std::deque< WasteStream >();
   commod_wf_map_ = std::map< std::string, ComponentPtr >();
   wf_wp_map_ = std::map< std::string, ComponentPtr >();
-  far_field_ = ComponentPtr(new Component());
-  buffer_template_ =  ComponentPtr(new Component());
+  far_field_ = Component::create();
+  buffer_template_ = Component::create();
 
   is_full_ = false;
+  inventory_mass_ = 0;
+  stocks_mass_ = 0;
+  coupled_transport_ = false;
+  decay_interval_ = 0;
+  decayed_until_ = -1;
   mapVars("x", "REAL", &x_);
   mapVars("y", "REAL", &y_);
   mapVars("z", "REAL", &z_);
@@ -78,6 +86,7 @@ GenericRepository::GenericRepository() {
   mapVars("startOperYear", "INTEGER", &start_op_yr_);
   mapVars("startOperMonth", "INTEGER", &start_op_mo_);
 }
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void GenericRepository::initModuleMembers(QueryEngine* qe) { 
   // initialize ordinary objects
@@ -98,6 +107,28 @@ void GenericRepository::initModuleMembers(QueryEngine* qe) {
     }
   }
 
+  // the coupled transport solver is optional, and off by default
+  if (qe->nElementsMatchingQuery("coupled_transport") == 1) {
+    coupled_transport_ = lexical_cast<bool>(qe->getElementContent("coupled_transport"));
+  }
+
+  // like the decay of the control block, the contents only decay if an 
+  // interval is given
+  if (qe->nElementsMatchingQuery("decay_interval") == 1) {
+    decay_interval_ = lexical_cast<int>(qe->getElementContent("decay_interval"));
+  }
+
+  // the thermal field is optional. Without it, the temperatures aren't 
+  // calculated and the loading isn't thermally limited
+  if (qe->nElementsMatchingQuery("thermal_field") == 1) {
+    QueryEngine* field_input = qe->queryElement("thermal_field");
+    thermal_field_ = ThermalFieldPtr(new ThermalField(
+          lexical_cast<double>(field_input->getElementContent("conductivity")),
+          lexical_cast<double>(field_input->getElementContent("diffusivity")),
+          lexical_cast<double>(field_input->getElementContent("ambient_temp")),
+          lexical_cast<double>(field_input->getElementContent("cutoff"))));
+  }
+
   // The repository accepts any commodities designated waste.
   // This will be a list
   int n_incommodities = qe->nElementsMatchingQuery("incommodity");
@@ -116,7 +147,7 @@ void GenericRepository::initModuleMembers(QueryEngine* qe) {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentPtr GenericRepository::initComponent(QueryEngine* qe){
-  ComponentPtr toRet = ComponentPtr(new Component());
+  ComponentPtr toRet = Component::create();
   // the component class initialization function will pass down the queryengine pointer
   toRet->initModuleMembers(qe);
   // all components have a name and a type
@@ -186,6 +217,8 @@ void GenericRepository::cloneModuleMembersFrom(FacilityModel* source)
   inventory_size_ = src->lifetime_;
   start_op_yr_ = src->start_op_yr_;
   start_op_mo_ = src->start_op_mo_;
+  coupled_transport_ = src->coupled_transport_;
+  decay_interval_ = src->decay_interval_;
   in_commods_ = src->in_commods_;
   far_field_->copy(src->far_field_);
   buffer_template_ = src->buffer_template_;
@@ -194,11 +227,25 @@ void GenericRepository::cloneModuleMembersFrom(FacilityModel* source)
   wf_wp_map_ = src->wf_wp_map_;
   commod_wf_map_ = src->commod_wf_map_;
 
+  // the clone heats its own rock, so its field starts out without sources
+  if (src->thermal_field_){
+    thermal_field_ = ThermalFieldPtr(new ThermalField(
+          src->thermal_field_->conductivity(),
+          src->thermal_field_->diffusivity(),
+          src->thermal_field_->ambient(),
+          src->thermal_field_->cutoff(),
+          src->thermal_field_->horizon()));
+  }
+
   // don't copy things that should start out empty
   // initialize empty structures instead
   stocks_ = std::deque< WasteStream >();
   inventory_ = std::deque< WasteStream >();
+  open_waste_packages_ = std::map< int, std::deque< ComponentPtr > >();
+  inventory_mass_ = 0;
+  stocks_mass_ = 0;
   is_full_ = false;
+  decayed_until_ = -1;
 
   addRowToParamsTable();
 }
@@ -261,6 +308,7 @@ void GenericRepository::addResource(Transaction trans, std::vector<rsrc_ptr> man
         << (*this_rsrc)->quantity();
     if ((*this_rsrc)->type()==MATERIAL_RES){
       stocks_.push_front(std::make_pair(boost::dynamic_pointer_cast<Material>(*this_rsrc), trans.commod()));
+      stocks_mass_ += stocks_.front().first->quantity();
     } else {
       std::string err = "The GenericRepository only accepts Material-type Resources.";
       throw CycException(err);
@@ -287,14 +335,16 @@ void GenericRepository::handleTick(int time)
 void GenericRepository::handleTock(int time) {
 
   // emplace the waste that's ready
-  emplaceWaste();
+  emplaceWaste(time);
 
   // calculate the heat
   transportHeat(time);
+
+  // decay the contents
+  decayNuclides(time);
   
   // calculate the nuclide transport
   transportNuclides(time);
-
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -371,6 +421,18 @@ double GenericRepository::getCapacity(std::string commod){
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 double GenericRepository::checkInventory(){
+  assert(totalsAgree(inventory_mass_, scanInventory()));
+  return inventory_mass_;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double GenericRepository::checkStocks(){
+  assert(totalsAgree(stocks_mass_, scanStocks()));
+  return stocks_mass_;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double GenericRepository::scanInventory(){
   double total = 0;
 
   // Iterate through the inventory and sum the amount of whatever
@@ -383,24 +445,37 @@ double GenericRepository::checkInventory(){
   return total;
 }
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double GenericRepository::checkStocks(){
+double GenericRepository::scanStocks(){
   double total = 0;
 
   // Iterate through the stocks and sum the amount of whatever
   // material unit is in each object.
-
-  if (!stocks_.empty()){
-    for (std::deque< WasteStream >::iterator iter = stocks_.begin(); iter != 
-        stocks_.end(); iter ++) {
-        total += iter->first->quantity();
-    };
-  };
+  for (std::deque< WasteStream >::iterator iter = stocks_.begin(); iter != 
+      stocks_.end(); iter ++) {
+    total += iter->first->quantity();
+  }
   return total;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void GenericRepository::emplaceWaste(){
-  // if there's anything in the stocks, try to emplace it
+bool GenericRepository::totalsAgree(double running, double scanned){
+  // the sums are taken in different orders, so allow for roundoff
+  return fabs(running - scanned) <= 1e-9*std::max(1.0, fabs(scanned));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GenericRepository::emplaceWaste(int the_time){
+  if (stocks_.empty() && current_waste_packages_.empty()) {
+    return;
+  }
+  // the component tree is about to change
+  if (scheduler_){
+    scheduler_->invalidate();
+  }
+  if (solver_){
+    solver_->invalidate();
+  }
+  // if there's anything in the stocks, condition and package it
   if (!stocks_.empty()) {
     // for each waste stream in the stocks
     for (std::deque< WasteStream >::const_iterator iter = stocks_.begin(); iter != 
@@ -422,32 +497,41 @@ void GenericRepository::emplaceWaste(){
       waste_forms_.push_back(current_waste_forms_.front());
       current_waste_forms_.pop_front();
     }
-    int nwp = current_waste_packages_.size();
-    // for each current_waste_package
-    for (int i=0; i < nwp; i++){
-      ComponentPtr iter = current_waste_packages_.front();
-      // try to load each package in the current buffer 
-      // if the package is full
-      if ( iter->isFull()
-          // and not too hot
-          //&& (*iter)->peak_temp(OUTER) <= current_buffer->temp_lim() or 
-          //too toxic
-          //&& (*iter)->peak_tox() <= current_buffer->tox_lim()
-          ) {
-        // emplace it in the buffer
-        loadBuffer(iter);
-        // take the waste package out of the current packagess
-        waste_packages_.push_back(iter);
-        current_waste_packages_.pop_front();
-      } else {
-        // if the waste package was either too hot or not full
-        // push it back on the stack
-        current_waste_packages_.push_back(iter);
-        current_waste_packages_.pop_front();
-      }
+    // the conditioned waste streams are now in the inventory
+    while (!stocks_.empty()) {
+      inventory_mass_ += stocks_.front().first->quantity();
       inventory_.push_back(stocks_.front());
       stocks_.pop_front();
-      // once the waste is emplaced, is there anything else to do?
+    }
+    stocks_mass_ = 0;
+  }
+  // every package waiting is tried, new or not, since a package that was 
+  // too hot may be accepted once its neighbours have cooled
+  int nwp = current_waste_packages_.size();
+  // for each current_waste_package
+  for (int i=0; i < nwp; i++){
+    ComponentPtr iter = current_waste_packages_.front();
+    // try to load each package in the current buffer 
+    // if the package is full
+    if ( iter->isFull()
+        // and not too hot
+        && thermallyAcceptable(iter, the_time)
+        //too toxic
+        //&& (*iter)->peak_tox() <= current_buffer->tox_lim()
+        ) {
+      // emplace it in the buffer
+      if (loadBuffer(iter)){
+        // the waste forms start heating the rock
+        addHeatSources(iter, the_time);
+      }
+      // take the waste package out of the current packagess
+      waste_packages_.push_back(iter);
+      current_waste_packages_.pop_front();
+    } else {
+      // if the waste package was either too hot or not full
+      // push it back on the stack
+      current_waste_packages_.push_back(iter);
+      current_waste_packages_.pop_front();
     }
   }
 }
@@ -469,8 +553,7 @@ ComponentPtr GenericRepository::conditionWaste(WasteStream waste_stream){
   // if there doesn't already exist a partially full one
   // @todo check for partially full wf's before creating new one (katyhuff)
   // create that waste form
-  current_waste_forms_.push_back(ComponentPtr(new Component()));
-  current_waste_forms_.back()->copy(chosen_wf_template);
+  current_waste_forms_.push_back(Component::create(chosen_wf_template));
   // and load in the waste stream
   current_waste_forms_.back()->absorb(waste_stream.first);
   return current_waste_forms_.back();
@@ -479,10 +562,8 @@ ComponentPtr GenericRepository::conditionWaste(WasteStream waste_stream){
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 ComponentPtr GenericRepository::packageWaste(ComponentPtr waste_form){
   // figure out what waste package to put the waste form in
-  bool loaded = false;
   ComponentPtr chosen_wp_template;
-  std::string name = waste_form->name();
-  chosen_wp_template = wf_wp_map_[name];
+  chosen_wp_template = wf_wp_map_[waste_form->name()];
   if (chosen_wp_template == NULL){
     std::string err_msg = "The waste form '";
     err_msg += (waste_form)->name();
@@ -490,27 +571,24 @@ ComponentPtr GenericRepository::packageWaste(ComponentPtr waste_form){
     throw CycException(err_msg);
   }
   ComponentPtr toRet;
-  // until the waste form has been loaded into a package
-  while (!loaded){
-    // look through the current waste packages 
-    for (std::deque<ComponentPtr>::const_iterator iter= 
-        current_waste_packages_.begin();
-        iter != current_waste_packages_.end();
-        iter++){
-      // if there already exists an only partially full one of the right kind
-      if ( !(*iter)->isFull() && (*iter)->name() == 
-          chosen_wp_template->name()){
-        // fill it
-        (*iter)->load(WP, waste_form);
-        toRet = (*iter);
-        loaded = true;
-      } }
+  // if there already exists an only partially full one of the right kind
+  std::deque<ComponentPtr>& open = open_waste_packages_[chosen_wp_template->template_id()];
+  while (!open.empty() && open.front()->isFull()){
+    open.pop_front();
+  }
+  if (!open.empty()){
+    // fill it
+    toRet = open.front()->load(WP, waste_form);
+  } else {
     // if no currently unfilled waste packages match, create a new waste package
-    current_waste_packages_.push_back(ComponentPtr( new Component() ));
-    current_waste_packages_.back()->copy(chosen_wp_template);
+    current_waste_packages_.push_back(Component::create(chosen_wp_template));
     // and load in the waste form
     toRet = current_waste_packages_.back()->load(WP, waste_form); 
-    loaded = true;
+    open.push_back(toRet);
+  }
+  // packages leave the index as soon as they fill up
+  if (toRet->isFull()){
+    open.pop_front();
   }
   return toRet;
 }
@@ -522,8 +600,7 @@ ComponentPtr GenericRepository::loadBuffer(ComponentPtr waste_package){
   if ( !(buffers_.empty()) && !(buffers_.front()->isFull())) {
     chosen_buffer = ComponentPtr(buffers_.front());
   } else if ( buffers_.size()*dx_ < x_) { 
-    chosen_buffer = ComponentPtr(new Component());
-    chosen_buffer->copy(buffer_template_);
+    chosen_buffer = Component::create(buffer_template_);
     buffers_.push_front(chosen_buffer);
     far_field_->load(FF, chosen_buffer);
     setPlacement(buffers_.front());
@@ -539,8 +616,8 @@ ComponentPtr GenericRepository::loadBuffer(ComponentPtr waste_package){
   // set the location of the waste package 
   setPlacement(waste_package);
   // set the location of the waste forms within the waste package
-  std::vector<ComponentPtr> daughters = waste_package->daughters();
-  for (std::vector<ComponentPtr>::iterator iter = daughters.begin();  
+  const std::vector<ComponentPtr>& daughters = waste_package->daughters();
+  for (std::vector<ComponentPtr>::const_iterator iter = daughters.begin();  
       iter != daughters.end(); 
       iter ++){
     setPlacement(*iter);
@@ -576,6 +653,8 @@ ComponentPtr GenericRepository::setPlacement(ComponentPtr comp){
       x = (comp->parent())->x();
       y = (comp->parent())->y();
       z = (comp->parent())->z();
+      // the waste form fills its package
+      length = (comp->parent())->geom()->length();
       break;
     default :
       std::string err = "ComponentType, '";
@@ -595,72 +674,163 @@ ComponentPtr GenericRepository::setPlacement(ComponentPtr comp){
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void GenericRepository::transportHeat(int time){
   // update the thermal BCs everywhere
+  if (thermal_field_){
+    updateTemps(time);
+  }
   // pass the transport heat signal through the components, inner -> outer
-  for ( std::deque< ComponentPtr >::const_iterator iter = waste_forms_.begin();
-      iter != waste_forms_.end();
-      iter++){
-    (*iter)->transportHeat(time);
+  scheduler()->run(&Component::transportHeat, time);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GenericRepository::updateTemps(int time){
+  // each package is at the temperature of its surface, and its waste forms 
+  // with it
+  for (std::deque<ComponentPtr>::const_iterator wp = 
+      emplaced_waste_packages_.begin(); wp != emplaced_waste_packages_.end(); 
+      ++wp){
+    Temp temp = thermal_field_->temp((*wp)->centroid(), (*wp)->outer_radius(), time);
+    (*wp)->set_temp(temp);
+    const std::vector<ComponentPtr>& daughters = (*wp)->daughters();
+    for (size_t i = 0; i < daughters.size(); i++) {
+      daughters[i]->set_temp(temp);
+    }
   }
-  for ( std::deque< ComponentPtr >::const_iterator iter = waste_packages_.begin();
-      iter != waste_packages_.end();
-      iter++){
-    (*iter)->transportHeat(time);
+  // each buffer is at the temperature of its hottest contact with a package
+  for (std::deque<ComponentPtr>::const_iterator buffer = buffers_.begin(); 
+      buffer != buffers_.end(); ++buffer){
+    Temp temp = thermal_field_->ambient();
+    const std::vector<ComponentPtr>& daughters = (*buffer)->daughters();
+    for (size_t i = 0; i < daughters.size(); i++) {
+      Radius r = std::max((*buffer)->inner_radius(), daughters[i]->outer_radius());
+      temp = std::max(temp, thermal_field_->temp(daughters[i]->centroid(), r, time));
+    }
+    (*buffer)->set_temp(temp);
   }
-  for ( std::deque< ComponentPtr >::const_iterator iter = buffers_.begin();
-      iter != buffers_.end();
-      iter++){
-    (*iter)->transportHeat(time);
+  far_field_->set_temp(thermal_field_->ambient());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GenericRepository::addHeatSources(ComponentPtr waste_package, 
+    int the_time){
+  if (!thermal_field_){
+    return;
+  }
+  const std::vector<ComponentPtr>& daughters = waste_package->daughters();
+  for (size_t i = 0; i < daughters.size(); i++) {
+    LumpedThermalPtr model = 
+      boost::dynamic_pointer_cast<LumpedThermal>(daughters[i]->thermal_model());
+    if (model){
+      double mass = daughters[i]->nuclide_model()->total_iso_mass();
+      thermal_field_->addSource(waste_package->centroid(), model->power(mass), 
+          model->decay_const(), the_time);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool GenericRepository::thermallyAcceptable(ComponentPtr waste_package, 
+    int the_time){
+  if (!thermal_field_){
+    return true;
+  }
+  // the package would go in the next slot, as setPlacement will place it, 
+  // in the current buffer or, if it is full, the next one
+  bool open_buffer = !buffers_.empty() && !buffers_.front()->isFull();
+  point_t next;
+  next.x_ = (emplaced_waste_packages_.size() + 1)*dx_ - dx_/2;
+  next.y_ = (buffers_.size() + (open_buffer ? -.5 : .5))*dy_;
+  next.z_ = dz_;
+  Temp lim = open_buffer ? buffers_.front()->temp_lim() : buffer_template_->temp_lim();
+
+  Radius r = waste_package->outer_radius();
+  Temp peak = thermal_field_->peakBound(next, r, the_time);
+  const std::vector<ComponentPtr>& daughters = waste_package->daughters();
+  for (size_t i = 0; i < daughters.size(); i++) {
+    LumpedThermalPtr model = 
+      boost::dynamic_pointer_cast<LumpedThermal>(daughters[i]->thermal_model());
+    if (model){
+      double mass = daughters[i]->nuclide_model()->total_iso_mass();
+      peak += thermal_field_->selfPeak(r, model->power(mass), model->decay_const());
+    }
   }
-  if ( far_field_){
-    far_field_->transportHeat(time);
+  if (peak > lim){
+    LOG(LEV_DEBUG2, "GenRepoFac") << "The waste package " << waste_package->ID() 
+      << " would reach " << peak << " K, above the limit of " << lim 
+      << " K, so it waits to be emplaced.";
+    return false;
   }
+  return true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void GenericRepository::transportNuclides(int the_time){
-  // update the nuclide transport BCs everywhere
-  // pass the transport nuclides signal through the components, inner -> outer
-  for ( std::deque< ComponentPtr >::const_iterator iter = waste_forms_.begin();
-      iter != waste_forms_.end();
-      ++iter){
-    (*iter)->transportNuclides(the_time);
+void GenericRepository::decayNuclides(int the_time){
+  if (decay_interval_ <= 0){
+    return;
   }
-  for ( std::deque< ComponentPtr >::const_iterator iter = waste_packages_.begin();
-      iter != waste_packages_.end();
-      ++iter){
-    (*iter)->transportNuclides(the_time);
+  if (!decay_){
+    decay_ = DecayOperator::load(MDB->file_path());
   }
-  for ( std::deque< ComponentPtr >::const_iterator iter = buffers_.begin();
-      iter != buffers_.end();
-      ++iter){
-    (*iter)->transportNuclides(the_time);
+  if (decayed_until_ < 0){
+    // nothing was held before the first tock, whenever it comes
+    decayed_until_ = the_time;
   }
-  if (far_field_){
-    far_field_->transportNuclides(the_time);
+  int dt = the_time - decayed_until_;
+  if (dt < decay_interval_){
+    return;
+  }
+  // every component decays its own contents in place, with the same 
+  // propagator for the step
+  const std::vector<ComponentPtr>& nodes = scheduler()->nodes();
+  for (size_t i = 0; i < nodes.size(); i++) {
+    nodes[i]->nuclide_model()->decay(*decay_, dt);
+  }
+  decayed_until_ = the_time;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void GenericRepository::transportNuclides(int the_time){
+  // update the nuclide transport BCs everywhere
+  // pass the transport nuclides signal through the components, inner -> outer
+  // each component is transported as soon as its own daughters are done
+  // or, if it is coupled, the whole tree is solved at once
+  if (coupled_transport_){
+    solver()->solve(the_time);
+  } else {
+    scheduler()->run(&Component::transportNuclides, the_time);
   }
   updateContaminantTable(the_time);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void GenericRepository::updateContaminantTable(int the_time) {
-  for ( std::deque< ComponentPtr >::const_iterator iter = waste_forms_.begin();
-      iter != waste_forms_.end();
-      ++iter){
+  const std::vector<ComponentPtr>& nodes = scheduler()->nodes();
+  std::vector<ComponentPtr>::const_iterator iter;
+  for (iter = nodes.begin(); iter != nodes.end(); ++iter){
     (*iter)->updateContaminantTable(the_time);
   }
-  for ( std::deque< ComponentPtr >::const_iterator iter = waste_packages_.begin();
-      iter != waste_packages_.end();
-      ++iter){
-    (*iter)->updateContaminantTable(the_time);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TockSchedulerPtr GenericRepository::scheduler(){
+  if (!scheduler_){
+    scheduler_ = TockSchedulerPtr(new TockScheduler());
   }
-  for ( std::deque< ComponentPtr >::const_iterator iter = buffers_.begin();
-      iter != buffers_.end();
-      ++iter){
-    (*iter)->updateContaminantTable(the_time);
+  if (scheduler_->dirty()){
+    scheduler_->rebuild(waste_forms_, waste_packages_, buffers_, far_field_);
+  }
+  return scheduler_;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+EBSSolverPtr GenericRepository::solver(){
+  if (!solver_){
+    solver_ = EBSSolverPtr(new EBSSolver(adv_vel_));
   }
-  if (far_field_){
-    far_field_->updateContaminantTable(the_time);
+  if (solver_->dirty()){
+    TockSchedulerPtr sched = scheduler();
+    solver_->rebuild(sched->nodes(), sched->parents());
   }
+  return solver_;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
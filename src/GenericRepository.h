@@ -11,6 +11,11 @@
 
 #include "FacilityModel.h"
 #include "Component.h"
+#include "TockScheduler.h"
+#include "EBSSolver.h"
+#include "DecayOperator.h"
+#include "ThermalField.h"
+#include "LumpedThermal.h"
 
 /**
    type definition for waste stream objects
@@ -221,6 +226,17 @@ protected:
      */
     std::deque<WasteStream> inventory_;
 
+    /**
+       The running total mass of the stocks [kg], kept by addResource and 
+       emplaceWaste
+     */
+    double stocks_mass_;
+
+    /**
+       The running total mass of the inventory [kg], kept by emplaceWaste
+     */
+    double inventory_mass_;
+
     /**
        The maximum size to which the inventory may grow..
        The GenericRepository must stop processing the material in its stocks 
@@ -246,6 +262,52 @@ protected:
      */
     int start_op_mo_;
 
+    /**
+       The scheduler that passes the tock through the component tree, 
+       created on first use
+     */
+    TockSchedulerPtr scheduler_;
+
+    /**
+       True if the nuclides are transported through the whole EBS in one
+       implicit solve, rather than by each component in turn. False (the
+       default) keeps the sequential transport of the component models.
+       The coupled solve only keeps each model's degradation and boundary 
+       concentration; see EBSSolver for what it leaves out.
+     */
+    bool coupled_transport_;
+
+    /**
+       The solver for the coupled transport, created on first use
+     */
+    EBSSolverPtr solver_;
+
+    /**
+       The decay data of the isotopes in the material database, loaded on
+       first use
+     */
+    DecayOperatorPtr decay_;
+
+    /**
+       The number of timesteps between decay calculations, as the decay 
+       interval of the control block. If it is 0, the default, the contents 
+       don't decay.
+     */
+    int decay_interval_;
+
+    /**
+       The time to which the contents of the components have been decayed, 
+       or -1 before the first decay
+     */
+    int decayed_until_;
+
+    /**
+       The temperature field of the emplaced waste, if the input gives one. 
+       Without it, no temperatures are calculated and the loading is not 
+       thermally limited.
+     */
+    ThermalFieldPtr thermal_field_;
+
     /**
        Reports true if the repository has reached capacity, false otherwise
      */
@@ -279,6 +341,13 @@ protected:
      */
     std::deque<ComponentPtr> current_waste_packages_;
 
+    /**
+       The current waste packages that still have room for a waste form, 
+       indexed by the template_id of the waste package template they were 
+       copied from
+     */
+    std::map<int, std::deque<ComponentPtr> > open_waste_packages_;
+
     /**
        The waste package components that have been emplaced
      */
@@ -322,9 +391,13 @@ protected:
     void makeRequests(int time);
 
     /**
-       Emplace the waste
+       Emplace the waste. The stocks are conditioned and packaged, and every 
+       package waiting, whether it was packaged now or before, is loaded 
+       into a buffer if it may be.
+
+       @param the_time the timestep at which to emplace the waste
      */
-    void emplaceWaste() ;
+    void emplaceWaste(int the_time) ;
     
     /**
        Condition the waste
@@ -374,6 +447,49 @@ protected:
      */
     void transportHeat(int time) ;
 
+    /**
+       Sets the temperature of every emplaced component from the thermal 
+       field. The packages, and their waste forms, are at the temperature of 
+       the package surface, and each buffer is at the hottest temperature 
+       where it meets one of its packages.
+
+       @param time the timestep at which to set the temperatures
+     */
+    void updateTemps(int time) ;
+
+    /**
+       Adds each waste form of an emplaced waste package that has a 
+       LumpedThermal model to the thermal field, as a source at the centroid 
+       of the package
+
+       @param waste_package the package that has just been emplaced
+       @param the_time the timestep at which it was emplaced
+     */
+    void addHeatSources(ComponentPtr waste_package, int the_time) ;
+
+    /**
+       Checks that a waste package, emplaced in the next slot, would keep 
+       the buffer below its temperature limit. The bound on the peak 
+       temperature includes the future peaks of the packages already 
+       emplaced, so a package that is rejected may be accepted once its 
+       neighbours have cooled.
+
+       @param waste_package the full package waiting to be emplaced
+       @param the_time the timestep at which it would be emplaced
+       @return true if the package may be emplaced
+     */
+    bool thermallyAcceptable(ComponentPtr waste_package, int the_time) ;
+
+    /**
+       Decays the contents of every component, in one pass, from the last 
+       time they were decayed, once every decay_interval_ timesteps. The 
+       first call decays nothing, and only starts the clock.
+
+       @param the_time the timestep to decay the contents to
+       @throws CycException if decay is on but there is no decay data
+     */
+    void decayNuclides(int the_time) ;
+
     /**
        Do nuclide transport calculations for each component, radially outward
 
@@ -381,6 +497,18 @@ protected:
      */
     void transportNuclides(int the_time) ;
 
+    /**
+       Returns the scheduler for the component tree, creating it on first use 
+       and rebuilding its graph if emplacement has changed the tree.
+     */
+    TockSchedulerPtr scheduler();
+
+    /**
+       Returns the coupled transport solver, creating it on first use and 
+       refactoring it if emplacement has changed the tree.
+     */
+    EBSSolverPtr solver();
+
     /**
        Record the state of each component, radially outward
 
@@ -398,6 +526,15 @@ protected:
       */
     void mapVars(std::string name, std::string type, void* ref);
 
+    /**
+       checks a running mass total against a full scan, to within roundoff
+
+       @param running the running total [kg]
+       @param scanned the total found by scanning each material [kg]
+       @return true if the two agree
+      */
+    static bool totalsAgree(double running, double scanned);
+
     /**
        This creates and fills  table that will hold the parameters that uniquely
        define all generic repository models in the simulation.
@@ -424,24 +561,46 @@ public:
     double getCapacity(std::string commod) ;
 
     /**
-       get the total mass of the stuff in the inventory
+       get the total mass of the stuff in the inventory, in constant time. 
+       Debug builds check the running total against scanInventory().
        
        @return the total mass of the processed materials in storage
      */
     double checkInventory();
 
     /**
-       get the total mass of the stuff in the stocks
+       get the total mass of the stuff in the stocks, in constant time. 
+       Debug builds check the running total against scanStocks().
        
        @return the total mass of the raw materials in storage
      */
     double checkStocks();
 
+    /**
+       sum the mass of every material in the inventory
+       
+       @return the total mass of the processed materials in storage
+     */
+    double scanInventory();
+
+    /**
+       sum the mass of every material in the stocks
+       
+       @return the total mass of the raw materials in storage
+     */
+    double scanStocks();
+
     /**
       get the advective velocity [m/s] of water movement in the repository
      */
     double adv_vel(){return adv_vel_;};
 
+    /// the number of waste packages emplaced in the buffers
+    int n_emplaced(){return emplaced_waste_packages_.size();};
+
+    /// the number of waste packages waiting to be emplaced
+    int n_waiting(){return current_waste_packages_.size();};
+
 /* ------------------- */ 
 
 };
@@ -35,7 +35,7 @@ GeometryPtr Geometry::copy(GeometryPtr src, point_t centroid){
   // need a fresh central position for each geometry,
   // no two objects may have exactly the same properties.
   // http://plato.stanford.edu/entries/identity-indiscernible/
-  GeometryPtr to_ret = GeometryPtr(new Geometry(src->inner_radius(),
+  GeometryPtr to_ret = share(new Geometry(src->inner_radius(),
       src->outer_radius(),
       centroid, src->length()));
   return to_ret;
@@ -7,6 +7,7 @@
 #define _GEOMETRY_H
 
 #include "boost/shared_ptr.hpp"
+#include "PoolAlloc.h"
 
 /// type definition for Radius in meters
 typedef double Radius;
@@ -38,7 +39,7 @@ typedef boost::shared_ptr<Geometry> GeometryPtr;
    The Geometry class holds information about the position, extent, and 
    structure of the component geometry.
  */
-class Geometry {
+class Geometry : public PoolAlloc<Geometry> {
   
 public:
   /**
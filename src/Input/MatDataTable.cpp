@@ -3,6 +3,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include <sstream>
+#include <algorithm>
 
 #include "MatDataTable.h"
 #include "SqliteDb.h"
@@ -14,53 +15,64 @@ using namespace std;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MatDataTable::MatDataTable() :
-  mat_(""),
-  elem_len_(0) {
+  mat_("") {
+  init(vector<element_t>());
 }
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MatDataTable::MatDataTable(string mat, vector<element_t> elem_vec, map<Elem, int> elem_index) :
-  mat_(mat),
-  elem_vec_(elem_vec),
-  elem_index_(elem_index)
+  mat_(mat)
 {
-  elem_len_= elem_vec_.size();
+  // each row carries its own element number, so the index isn't needed
+  init(elem_vec);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-MatDataTable::~MatDataTable() {
-}
-
-//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MatDataTable::K_d(Elem ent){
-  check_validity(ent);
-  return elem_vec_[ent].K_d;
+MatDataTable::MatDataTable(string mat, const vector<element_t>& elem_vec) :
+  mat_(mat)
+{
+  init(elem_vec);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MatDataTable::S(Elem ent){
-  check_validity(ent);
-  return elem_vec_[ent].S;
+MatDataTable::~MatDataTable() {
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MatDataTable::D(Elem ent){
-  check_validity(ent);
-  return elem_vec_[ent].D;
+void MatDataTable::init(const vector<element_t>& elem_vec){
+  int max_z = -1;
+  vector<element_t>::const_iterator it;
+  for(it = elem_vec.begin(); it != elem_vec.end(); ++it){
+    if( (*it).Z < 0 ){
+      stringstream err;
+      err << "Element " << (*it).Z << " in the " << mat_ 
+        << " table is not valid";
+      throw CycException(err.str());
+    }
+    max_z = max(max_z, (*it).Z);
+  }
+  sentinel_ = max_z + 1;
+  // one more entry than the elements, for the sentinel
+  D_.assign(sentinel_ + 1, 0);
+  K_d_.assign(sentinel_ + 1, 0);
+  S_.assign(sentinel_ + 1, 0);
+  valid_.assign(sentinel_ + 1, 0);
+  for(it = elem_vec.begin(); it != elem_vec.end(); ++it){
+    D_[(*it).Z] = (*it).D;
+    K_d_[(*it).Z] = (*it).K_d;
+    S_[(*it).Z] = (*it).S;
+    valid_[(*it).Z] = 1;
+  }
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void MatDataTable::check_validity(Elem ent) { 
-  map<Elem, int>::iterator it;
-  it=elem_index_.find(ent);
-  if (it==elem_index_.end()){
-    stringstream err;
-    err << "Element " << ent << " not valid";
-    throw CycException(err.str());
-  }
+void MatDataTable::invalid(Elem ent) const { 
+  stringstream err;
+  err << "Element " << ent << " not valid";
+  throw CycException(err.str());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MatDataTable::data(Elem ent, ChemDataType data) {
+double MatDataTable::data(Elem ent, ChemDataType data) const {
   double to_ret;
   switch( data ){
     case DISP :
@@ -28,12 +28,17 @@ typedef struct element_t
 } element_t;
 
 class MatDataTable;
-typedef boost::shared_ptr<MatDataTable> MatDataTablePtr;
+typedef boost::shared_ptr<const MatDataTable> MatDataTablePtr;
 
 /**
    @class MatDataTable 
    The MatDataTable class provides an interface to the mat_data.sqlite 
    database, providing a robust and correct mass lookup by isotope 
+
+   The data are stored by column, each column indexed directly by the 
+   element number Z, so that each lookup is a single load. One extra 
+   sentinel entry past the largest element catches every element that is 
+   out of range.
  */
 class MatDataTable {
 private:
@@ -50,11 +55,21 @@ public:
      Fully initializes the object
 
     @param mat the mat_ data member, a string
-    @param elem_vec the elem_vec_ data member, a vector of element structs, the data
-    @param elem_index the elem_index_ data member, mapping the element IDs to indices
+    @param elem_vec a vector of element structs, the data
+    @param elem_index mapping the element IDs to indices. Each row carries 
+    its own Z, so this is no longer used, but is kept for existing callers.
     */
   MatDataTable(std::string mat, std::vector<element_t> elem_vec, std::map<Elem, int> elem_index);
 
+  /**
+     Detailed constructor for the MatDataTable class
+     Fully initializes the object
+
+    @param mat the mat_ data member, a string
+    @param elem_vec the rows of the table, one per element
+    */
+  MatDataTable(std::string mat, const std::vector<element_t>& elem_vec);
+
   /**
      Destructor for the NullFacility class. 
      Makes certain to delete all appropriate data on the stack. 
@@ -68,8 +83,13 @@ public:
 
      @return K_d a double, the distribution coefficient [kg/kg] for the 
      element ent in the material mat. 
+     @throws CycException if the element has no row in the table
     */
-  double K_d(Elem ent);
+  double K_d(Elem ent) const {
+    int i = index(ent);
+    if( !valid_[i] ){ invalid(ent); }
+    return K_d_[i];
+  };
 
   /**
      get the solubility limit for some element in this material 
@@ -78,8 +98,13 @@ public:
 
      @return S a double, the solubility limit [kg/m^3] for the element 
      ent in the material mat. 
+     @throws CycException if the element has no row in the table
     */
-  double S(Elem ent);
+  double S(Elem ent) const {
+    int i = index(ent);
+    if( !valid_[i] ){ invalid(ent); }
+    return S_[i];
+  };
 
   /**
      get the dispersion coefficient [kg/m^2/s] for some element in this material
@@ -88,9 +113,23 @@ public:
 
      @return D a double, the dispersion coefficient [kg/m^2/s] for the 
      element ent in the material mat. 
+     @throws CycException if the element has no row in the table
     */
-  double D(Elem ent);
+  double D(Elem ent) const {
+    int i = index(ent);
+    if( !valid_[i] ){ invalid(ent); }
+    return D_[i];
+  };
 
+  /**
+     returns true if this element has a row entry in the table
+
+     @param ent an identifier of type Elem, which is an int 
+    */
+  bool valid(Elem ent) const {return valid_[index(ent)];};
+
+  /// the largest element number in the table
+  Elem max_elem() const {return sentinel_ - 1;};
 
   /** 
      gets a specific data object for some element in this material. 
@@ -100,7 +139,7 @@ public:
 
      @return the data of type data for element elt in this material.
     */
-  double data(Elem ent, ChemDataType data);
+  double data(Elem ent, ChemDataType data) const;
 
 
   /**
@@ -108,15 +147,30 @@ public:
 
      @return mat_
      */
-  std::string mat(){return mat_;};
+  std::string mat() const {return mat_;};
 
 protected:
   /**
-     checks whether this element has a row entry in the table.
-     ideally all of them will... 
-     @throws CycException when theres some drama
+     fills the columns from the rows of the table
+
+     @param elem_vec the rows, one per element, in any order
     */
-  void check_validity(Elem ent);
+  void init(const std::vector<element_t>& elem_vec);
+
+  /**
+     the column index of an element. Elements outside of the table all 
+     map to the sentinel index, whose row is never valid.
+    */
+  int index(Elem ent) const {
+    return (ent >= 0 && ent < sentinel_) ? ent : sentinel_;
+  };
+
+  /**
+     throws the exception for an element that has no row in the table
+     @throws CycException always
+    */
+  void invalid(Elem ent) const;
+
   /**
      The material that this table represents, 
      specifically, the name of the table in the DB
@@ -124,19 +178,29 @@ protected:
   std::string mat_;
 
   /**
-     The integer length (number of rows) of the tables 
+     The index of the sentinel, one past the largest element in the table
+   */
+  int sentinel_;
+
+  /**
+     The dispersion coefficient of each element, indexed by Z
+   */
+  std::vector<double> D_;
+
+  /**
+     The distribution coefficient of each element, indexed by Z
    */
-  int elem_len_;
+  std::vector<double> K_d_;
 
   /**
-     The vector of element structs that holds the data in the mass table 
+     The solubility limit of each element, indexed by Z
    */
-  std::vector<element_t> elem_vec_;
+  std::vector<double> S_;
 
   /** 
-     a map for index lookup in the element vector. 
+     Nonzero for each element, indexed by Z, that has a row in the table
    */
-  std::map<Elem, int> elem_index_;
+  std::vector<char> valid_;
 };
 
 #endif
@@ -2,100 +2,398 @@
 
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <sstream>
+#include <boost/cstdint.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include "MaterialDB.h"
 
 #include "Env.h"
 #include "CycException.h"
+#include "Logger.h"
 
 using namespace std;
+namespace fs = boost::filesystem;
+namespace ipc = boost::interprocess;
 
 MaterialDB* MaterialDB::instance_ = 0;
+boost::once_flag MaterialDB::instance_flag_ = BOOST_ONCE_INIT;
+
+/// identifies a MaterialDB snapshot file
+static const char SNAPSHOT_MAGIC[8] = {'C','Y','D','E','R','M','D','B'};
+
+/// the snapshot header, at the start of the file
+struct SnapshotHeader {
+  char magic[8];
+  boost::int32_t version;
+  boost::int32_t n_tables;
+  boost::int64_t source_size;
+  boost::int64_t source_mtime;
+  boost::int64_t source_changes;
+};
+
+/// one entry per table, following the header
+struct SnapshotTable {
+  char name[64];
+  boost::int32_t first_row;
+  boost::int32_t n_rows;
+};
+
+/// one entry per row, following the tables
+struct SnapshotRow {
+  boost::int32_t Z;
+  boost::int32_t pad;
+  double D;
+  double K_d;
+  double S;
+};
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MaterialDB* MaterialDB::Instance() {
-  // If we haven't created a MaterialDB yet, create it. 
-  // Return it either way
-  if (0 == instance_) {
-    instance_ = new MaterialDB();
-  }
+  // the first caller creates and loads the MaterialDB, and any others 
+  // wait for it. After that, this is just a load. 
+  boost::call_once(&MaterialDB::createInstance, instance_flag_);
   return instance_;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::createInstance() {
+  instance_ = new MaterialDB();
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MaterialDB::MaterialDB() {
   file_path_ = Env::getInstallPath() + "/share/mat_data.sqlite";
+  snapshot_path_ = snapshotPath(file_path_, cacheDir());
+  load();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MaterialDB::MaterialDB(string file_path, string snapshot_dir) {
+  file_path_ = file_path;
+  if( snapshot_dir.empty() ){
+    snapshot_dir = cacheDir();
+  }
+  snapshot_path_ = snapshotPath(file_path_, snapshot_dir);
+  load();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MaterialDB::cacheDir() {
+  const char* dir = getenv("CYDER_CACHE_DIR");
+  if( dir != NULL && *dir != '\0' ){
+    return dir;
+  }
+  dir = getenv("XDG_CACHE_HOME");
+  if( dir != NULL && *dir != '\0' ){
+    return (fs::path(dir) / "cyder").string();
+  }
+  dir = getenv("HOME");
+  if( dir != NULL && *dir != '\0' ){
+    return (fs::path(dir) / ".cache" / "cyder").string();
+  }
+  boost::system::error_code ec;
+  return (fs::temp_directory_path(ec) / "cyder").string();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string MaterialDB::snapshotPath(string file_path, string snapshot_dir) {
+  // databases with the same name in different places share the cache 
+  // directory, so the name carries a hash of the full path
+  fs::path source = fs::absolute(fs::path(file_path));
+  stringstream name;
+  name << source.filename().string() << "." << hex 
+    << boost::hash<string>()(source.string()) << ".snapshot";
+  return (fs::path(snapshot_dir) / name.str()).string();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MaterialDB::~MaterialDB() {
-  delete instance_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MaterialDB::K_d(string mat, Elem ent){
-  return table(mat)->K_d(ent);
+double MaterialDB::K_d(string mat, Elem ent) const {
+  return find(mat).K_d(ent);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MaterialDB::S(string mat, Elem ent){
-  return table(mat)->S(ent);
+double MaterialDB::S(string mat, Elem ent) const {
+  return find(mat).S(ent);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-double MaterialDB::D(string mat, Elem ent){
-  return table(mat)->D(ent);
+double MaterialDB::D(string mat, Elem ent) const {
+  return find(mat).D(ent);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-MatDataTablePtr MaterialDB::table(string mat) {
-  MatDataTablePtr to_ret;
-  if(initialized(mat) ){
-    to_ret = (*tables_.find(mat)).second;
-  } else {
-    to_ret = initializeFromSQL(mat);
-    tables_.insert(make_pair(mat,to_ret));
+MatDataTablePtr MaterialDB::table(string mat) const {
+  map<string, MatDataTablePtr>::const_iterator it = tables_.find(mat);
+  if( it == tables_.end() ){
+    unknown(mat);
   }
-  return to_ret;
+  return (*it).second;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool MaterialDB::initialized(string mat){
-  map<string,MatDataTablePtr>::iterator it;
-  it=tables_.find(mat);
-  return it!=tables_.end()? true : false; 
+const MatDataTable& MaterialDB::find(const string& mat) const {
+  map<string, MatDataTablePtr>::const_iterator it = tables_.find(mat);
+  if( it == tables_.end() ){
+    unknown(mat);
+  }
+  return *((*it).second);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-MatDataTablePtr MaterialDB::initializeFromSQL(string mat) {
-  SqliteDb* db = new SqliteDb(file_path_);
-
-  std::vector<StrList> znums = db->query("SELECT elem FROM "+mat);
-  std::vector<StrList> dnums = db->query("SELECT d FROM "+mat);
-  std::vector<StrList> knums = db->query("SELECT k_d FROM "+mat);
-  std::vector<StrList> snums = db->query("SELECT s FROM "+mat);
- 
-  vector<element_t> elem_vec;
-  map<Elem, int> elem_index;
-  for (int i = 0; i < znums.size(); i++){
-    // // obtain the database row and declare the appropriate members
-    string zStr = znums.at(i).at(0);
-    string dStr = dnums.at(i).at(0);
-    string kStr = knums.at(i).at(0);
-    string sStr = snums.at(i).at(0);
-    Elem z = atoi( zStr.c_str() );
-    double d = atof( dStr.c_str() );
-    double k = atof( kStr.c_str() );
-    double s = atof( sStr.c_str() );
-    // create a element member and add it to the element vector
-    element_t e = {z, d, k, s};
+void MaterialDB::unknown(const string& mat) const {
+  string err = "There is no material named " + mat + " in " + file_path_;
+  if( !load_error_.empty() ){
+    err += ", which could not be loaded: " + load_error_;
+  }
+  LOG(LEV_ERROR,"GRMatDB") << err;
+  throw CycException(err);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MaterialDB::initialized(string mat) const {
+  return tables_.find(mat) != tables_.end();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MaterialDB::readTable(SqliteDb& db, string mat, 
+    vector<element_t>& elem_vec) {
+  // a material table has all of the material columns
+  int n_found = 0;
+  {
+    SqliteCursor info(db, "PRAGMA table_info(" + mat + ")");
+    while( info.next() ){
+      string col = info.getText(1);
+      if( col == "elem" || col == "d" || col == "k_d" || col == "s" ){
+        ++n_found;
+      }
+    }
+  }
+  if( n_found < 4 ){
+    return false;
+  }
+
+  SqliteCursor rows(db, "SELECT elem, d, k_d, s FROM " + mat);
+  while( rows.next() ){
+    element_t e = {rows.getInt(0), rows.getDouble(1), rows.getDouble(2), 
+      rows.getDouble(3)};
     elem_vec.push_back(e);
-    // log it accordingly
-    elem_index.insert(make_pair(z, i));
   }
-  MatDataTablePtr to_ret = MatDataTablePtr(new MatDataTable(mat, elem_vec, elem_index)); 
-  delete db;
-  return to_ret;
+  return true;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::load() {
+  try {
+    if( !loadSnapshot() ){
+      loadFromSQL();
+      writeSnapshot();
+    }
+  } catch ( CycException& e ) {
+    // every lookup will fail, and say why
+    tables_.clear();
+    load_error_ = e.what();
+    LOG(LEV_WARN,"GRMatDB") << "Unable to load the material tables: " 
+      << e.what();
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::loadFromSQL() {
+  long long size, mtime, changes;
+  if( !sourceStamp(size, mtime, changes) ){
+    throw CycIOException("The material database doesn't exist: " + 
+        file_path_);
+  }
+
+  SqliteDb db(file_path_);
+  vector<string> names;
+  {
+    SqliteCursor cursor(db, 
+        "SELECT name FROM sqlite_master WHERE type='table'");
+    while( cursor.next() ){
+      names.push_back(cursor.getText(0));
+    }
+  }
+  vector<string>::iterator it;
+  for(it = names.begin(); it != names.end(); ++it){
+    string mat = *it;
+    vector<element_t> elem_vec;
+    if( readTable(db, mat, elem_vec) ){
+      tables_[mat] = MatDataTablePtr(new MatDataTable(mat, elem_vec));
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MaterialDB::sourceStamp(long long& size, long long& mtime, 
+    long long& changes) {
+  boost::system::error_code ec;
+  size = fs::file_size(file_path_, ec);
+  if( ec ){
+    return false;
+  }
+  mtime = fs::last_write_time(file_path_, ec);
+  if( ec ){
+    return false;
+  }
+  // the change counter is a big-endian integer at byte 24 of the header
+  unsigned char header[28];
+  ifstream in(file_path_.c_str(), ios::binary);
+  changes = 0;
+  if( in.read(reinterpret_cast<char*>(header), sizeof(header)) ){
+    for(int i = 24; i < 28; ++i){
+      changes = (changes << 8) | header[i];
+    }
+  }
+  return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MaterialDB::loadSnapshot() {
+  long long size, mtime, changes;
+  boost::system::error_code ec;
+  if( !sourceStamp(size, mtime, changes) || 
+      !fs::exists(snapshot_path_, ec) ){
+    return false;
+  }
+
+  map<string, MatDataTablePtr> tables;
+  try {
+    ipc::file_mapping file(snapshot_path_.c_str(), ipc::read_only);
+    ipc::mapped_region region(file, ipc::read_only);
+    const char* begin = static_cast<const char*>(region.get_address());
+    size_t len = region.get_size();
+
+    if( len < sizeof(SnapshotHeader) ){
+      return false;
+    }
+    const SnapshotHeader* head = 
+      reinterpret_cast<const SnapshotHeader*>(begin);
+    if( memcmp(head->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        head->version != SNAPSHOT_VERSION || 
+        head->source_size != size || head->source_mtime != mtime ||
+        head->source_changes != changes ||
+        head->n_tables < 0 ){
+      return false;
+    }
+
+    size_t tables_end = sizeof(SnapshotHeader) + 
+      head->n_tables*sizeof(SnapshotTable);
+    if( len < tables_end ){
+      return false;
+    }
+    const SnapshotTable* entries = 
+      reinterpret_cast<const SnapshotTable*>(begin + sizeof(SnapshotHeader));
+    const SnapshotRow* rows = 
+      reinterpret_cast<const SnapshotRow*>(begin + tables_end);
+    size_t n_rows = (len - tables_end)/sizeof(SnapshotRow);
+
+    for(int t = 0; t < head->n_tables; ++t){
+      const SnapshotTable& entry = entries[t];
+      if( entry.first_row < 0 || entry.n_rows < 0 || 
+          size_t(entry.first_row) + entry.n_rows > n_rows ){
+        return false;
+      }
+      vector<element_t> elem_vec;
+      elem_vec.reserve(entry.n_rows);
+      for(int i = entry.first_row; i < entry.first_row + entry.n_rows; ++i){
+        element_t e = {rows[i].Z, rows[i].D, rows[i].K_d, rows[i].S};
+        elem_vec.push_back(e);
+      }
+      string mat(entry.name, strnlen(entry.name, sizeof(entry.name)));
+      tables[mat] = MatDataTablePtr(new MatDataTable(mat, elem_vec));
+    }
+  } catch ( ipc::interprocess_exception& e ) {
+    return false;
+  }
+  tables_.swap(tables);
+  return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MaterialDB::writeSnapshot() {
+  long long size, mtime, changes;
+  if( !sourceStamp(size, mtime, changes) ){
+    return;
+  }
+
+  SnapshotHeader head;
+  memcpy(head.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  head.version = SNAPSHOT_VERSION;
+  head.n_tables = 0;
+  head.source_size = size;
+  head.source_mtime = mtime;
+  head.source_changes = changes;
+
+  vector<SnapshotTable> entries;
+  vector<SnapshotRow> rows;
+  map<string, MatDataTablePtr>::iterator it;
+  for(it = tables_.begin(); it != tables_.end(); ++it){
+    if( (*it).first.size() >= sizeof(SnapshotTable().name) ){
+      // the name doesn't fit, so this snapshot can't be used
+      return;
+    }
+    SnapshotTable entry;
+    memset(entry.name, 0, sizeof(entry.name));
+    memcpy(entry.name, (*it).first.c_str(), (*it).first.size());
+    entry.first_row = rows.size();
+    MatDataTablePtr table = (*it).second;
+    for(Elem z = 0; z <= table->max_elem(); ++z){
+      if( table->valid(z) ){
+        SnapshotRow row = {z, 0, table->D(z), table->K_d(z), table->S(z)};
+        rows.push_back(row);
+      }
+    }
+    entry.n_rows = rows.size() - entry.first_row;
+    entries.push_back(entry);
+  }
+  head.n_tables = entries.size();
+
+  // many runs may start at once, so each writes its own file and the 
+  // last one to finish wins
+  boost::system::error_code ec;
+  fs::create_directories(fs::path(snapshot_path_).parent_path(), ec);
+  if( ec ){
+    LOG(LEV_DEBUG2,"GRMatDB") << "Unable to make the snapshot directory for " 
+      << snapshot_path_;
+    return;
+  }
+  fs::path tmp = fs::unique_path(snapshot_path_ + ".%%%%-%%%%-%%%%", ec);
+  if( ec ){
+    return;
+  }
+  {
+    ofstream out(tmp.string().c_str(), ios::binary | ios::trunc);
+    out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    if( !entries.empty() ){
+      out.write(reinterpret_cast<const char*>(&entries[0]), 
+          entries.size()*sizeof(SnapshotTable));
+    }
+    if( !rows.empty() ){
+      out.write(reinterpret_cast<const char*>(&rows[0]), 
+          rows.size()*sizeof(SnapshotRow));
+    }
+    if( !out ){
+      out.close();
+      fs::remove(tmp, ec);
+      LOG(LEV_DEBUG2,"GRMatDB") << "Unable to write the snapshot " 
+        << snapshot_path_;
+      return;
+    }
+  }
+  fs::rename(tmp, snapshot_path_, ec);
+  if( ec ){
+    fs::remove(tmp, ec);
+  }
+}
 
@@ -4,6 +4,7 @@
 
 #include <string>
 #include <map>
+#include <boost/thread/once.hpp>
 #include "SqliteDb.h"
 #include "MatDataTable.h"
 
@@ -16,6 +17,16 @@ typedef int Elem;
    @class MaterialDB 
    The MaterialDB class provides an interface to the mat_data.sqlite 
    database, providing a robust and correct mass lookup by isotope 
+
+   Every material table is loaded when the MaterialDB is created. The 
+   tables are then written to a binary snapshot in the user's cache 
+   directory (see cacheDir()), which later runs map and read instead of 
+   querying the database, so long as the database hasn't changed since. 
+   The database itself may be installed read-only.
+
+   Once loaded, neither the tables nor the MaterialDB change, so lookups 
+   may be made from any number of threads without a lock. A material 
+   that isn't in the database is an error. 
  */
 class MaterialDB {
 private:
@@ -24,15 +35,29 @@ private:
     */
   static MaterialDB* instance_;
 
+  /** 
+     Ensures the singleton is created exactly once
+    */
+  static boost::once_flag instance_flag_;
+
+  /// creates the singleton, called once
+  static void createInstance();
+
   /**
     this database's file path
    */
   std::string file_path_;
 
+  /**
+    the path of the binary snapshot of this database
+   */
+  std::string snapshot_path_;
+
 public:
   /** 
      Provides a singleton instance for the MaterialDB.
      Like the Highlander, there should be only one. 
+     It is created and loaded by the first call, from whichever thread. 
 
      @return a pointer to the MaterialDB
     */
@@ -44,6 +69,16 @@ public:
    */
   MaterialDB();
 
+  /**
+     Constructor for the MaterialDB class. 
+     Initializes the data from the database at the provided path.
+
+     @param file_path the path to the sqlite database
+     @param snapshot_dir the directory the snapshot is kept in, cacheDir() 
+     if empty
+   */
+  MaterialDB(std::string file_path, std::string snapshot_dir="");
+
   /**
      Destructor for the NullFacility class. 
      Makes certain to delete all appropriate data on the stack. 
@@ -58,8 +93,9 @@ public:
 
      @return K_d a double, the distribution coefficient [kg/kg] for the 
      element ent in the material mat. 
+     @throws CycException if the material or element isn't in the database
     */
-  double K_d(std::string mat, Elem ent);
+  double K_d(std::string mat, Elem ent) const;
 
   /**
      get the solubility limit for some element in some material of interest
@@ -69,8 +105,9 @@ public:
 
      @return S a double, the solubility limit [kg/m^3] for the element 
      ent in the material mat. 
+     @throws CycException if the material or element isn't in the database
     */
-  double S(std::string mat, Elem ent);
+  double S(std::string mat, Elem ent) const;
 
   /**
      get the dispersion coefficient [kg/m^2/s] for some element
@@ -81,13 +118,9 @@ public:
 
      @return D a double, the dispersion coefficient [kg/m^2/s] for the 
      element ent in the material mat. 
+     @throws CycException if the material or element isn't in the database
     */
-  double D(std::string mat, Elem ent);
-
-  /** 
-     a map from the names of materials to table pointers
-    */
-  std::map<std::string, MatDataTablePtr> tables_;
+  double D(std::string mat, Elem ent) const;
 
   /**
      get a piece of data for some element in some material of interest
@@ -116,24 +149,126 @@ public:
      @param mat a string indicating the name of the table (clay, salt, etc.)
 
      @return a MatDataTablePtr holding the data associated with the mat
+     @throws CycException if there is no such material
      */
-  MatDataTablePtr table(std::string mat);
+  MatDataTablePtr table(std::string mat) const;
+
+  /// the loaded tables, by the names of their materials
+  const std::map<std::string, MatDataTablePtr>& tables() const {
+    return tables_;
+  };
+
+  /// the path of the database
+  std::string file_path(){return file_path_;};
+
+  /// the path of the binary snapshot of the database
+  std::string snapshot_path(){return snapshot_path_;};
+
+  /**
+     the directory snapshots are kept in by default: $CYDER_CACHE_DIR if it 
+     is set, else $XDG_CACHE_HOME/cyder, else $HOME/.cache/cyder, else 
+     cyder in the temporary directory. It is made when a snapshot is 
+     first written.
+   */
+  static std::string cacheDir();
+
+  /**
+     the path of the snapshot of a database
+
+     @param file_path the path to the sqlite database
+     @param snapshot_dir the directory the snapshot is kept in
+   */
+  static std::string snapshotPath(std::string file_path, 
+      std::string snapshot_dir);
+
+  /// the version of the snapshot format, bumped whenever the layout changes
+  static const int SNAPSHOT_VERSION = 1;
 
 protected:
+  /** 
+     a map from the names of materials to table pointers, 
+     filled by load() and never changed after
+    */
+  std::map<std::string, MatDataTablePtr> tables_;
+
+  /**
+     why the tables could not be loaded, if they couldn't
+   */
+  std::string load_error_;
+
+  /**
+     the table for a material, without copying the pointer
+
+     @param mat the name of the material
+     @throws CycException if there is no such material
+   */
+  const MatDataTable& find(const std::string& mat) const;
+
+  /**
+     throws the exception for a material that isn't in the database
+     @throws CycException always
+   */
+  void unknown(const std::string& mat) const;
+
+  /**
+     loads every material table, from the snapshot if it is current and 
+     from the database otherwise, then refreshes the snapshot
+   */
+  void load();
+
+  /**
+     loads every material table in the database, with one query per table.
+     Tables without the elem, d, k_d and s columns are not materials, and 
+     are skipped. 
+   */
+  void loadFromSQL();
+
+  /**
+     loads every material table from the snapshot
+
+     @return false if there is no snapshot, or it is out of date or 
+     unreadable, in which case nothing is loaded
+   */
+  bool loadSnapshot();
+
+  /**
+     writes every loaded table to the snapshot. The snapshot is written to 
+     a temporary file and moved into place, so that a reader never sees a 
+     partial snapshot. Failing to write it is not an error. 
+   */
+  void writeSnapshot();
+
+  /**
+     the size, modification time and change counter of the database, which 
+     the snapshot must match to be current. The change counter is kept by 
+     sqlite in the database header, and catches changes within the same 
+     second that leave the size as it was. 
+
+     @param size set to the size of the database [bytes]
+     @param mtime set to the modification time of the database
+     @param changes set to the change counter of the database
+     @return false if the database doesn't exist
+   */
+  bool sourceStamp(long long& size, long long& mtime, long long& changes);
+
   /**
      checks whether a table associated with a particular mat has been created
 
      @param mat the string name of the table to check the existence of
      */
-  bool initialized(std::string mat);
+  bool initialized(std::string mat) const;
 
   /** 
-     a function to initialize a large array of element_t structs via the 
-     SQLite/C++ API 
+     reads a material table with a single query, reading each column as 
+     its own type
 
-     @param mat the string indicatin the material this table should represent
+     @param db the database
+     @param mat the name of the table
+     @param elem_vec the rows of the table are appended to this
+     @return false if the table doesn't have the material columns
    */
-  MatDataTablePtr initializeFromSQL(std::string mat);
+  static bool readTable(SqliteDb& db, std::string mat, 
+      std::vector<element_t>& elem_vec);
 
 };
 
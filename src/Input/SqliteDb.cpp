@@ -7,6 +7,9 @@
 
 #include <fstream>
 
+/// the most statements kept in the cache of each database
+static const unsigned int MAX_CACHED_STMTS = 64;
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 SqliteDb::SqliteDb(std::string filename){
   db_ = NULL;
@@ -17,8 +20,12 @@ SqliteDb::SqliteDb(std::string filename){
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 SqliteDb::~SqliteDb() {
+  // never throws. A statement still held by a cursor keeps the connection 
+  // until it is finalized.
   if ( isOpen_ ) {
-    close();
+    clearCache();
+    sqlite3_close_v2(db_);
+    isOpen_ = false;
   }
 }
 
@@ -30,7 +37,10 @@ void SqliteDb::overwrite() {
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 void SqliteDb::close() {
   if ( isOpen_ ) {
-    if (sqlite3_close(db_) == SQLITE_OK) {
+    clearCache();
+    // a cursor that is still open finalizes its statement when it's done, 
+    // and the connection is closed then
+    if (sqlite3_close_v2(db_) == SQLITE_OK) {
       isOpen_ = false;
     } else {
       throw CycIOException("Failed to close database: " + path_);
@@ -63,64 +73,154 @@ void SqliteDb::open() {
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 void SqliteDb::execute(std::string sql) {
-  open();
-
-  sqlite3_stmt *statement;
-  int check_query = 
-    sqlite3_prepare_v2(db_, sql.c_str(), -1, &statement, 0);
-  if(check_query == SQLITE_OK) {
-    int result = sqlite3_step(statement);
-    sqlite3_finalize(statement);
-  }
-
-  // collect sqlite errors
-  std::string error = sqlite3_errmsg(db_);
-  if(error != "not an error") {
-    throw CycIOException("SQL error: " + sql + " " + error);
+  SqliteCursor cursor(*this, sql);
+  while( cursor.next() ){
   }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 std::vector<StrList> SqliteDb::query(std::string sql){  
-  open();
-
-  sqlite3_stmt *statement;
+  SqliteCursor cursor(*this, sql);
   std::vector<StrList> results;
-  
-  // query the database
-  int check_query = 
-    sqlite3_prepare_v2(db_, sql.c_str(), -1, &statement, 0);
-  if(check_query == SQLITE_OK){
-    int cols = sqlite3_column_count(statement);
-    int result = 0;
-    while(true){
-      result = sqlite3_step(statement);
-      if(result != SQLITE_ROW){
-        break;
-      }
+  int cols = cursor.columns();
+  while( cursor.next() ){
+    StrList values;
+    for(int col = 0; col < cols; col++){
+      values.push_back(cursor.getText(col));  // now we will never push NULL
+    }
+    results.push_back(values);
+  } 
+  return results;  
+}
 
-      StrList values;
-      for(int col = 0; col < cols; col++){
-        std::string  val;
-        char * ptr = (char*)sqlite3_column_text(statement, col);
-        if(ptr) {
-          val = ptr;
-        } else {
-          val = "";
-        }
-        values.push_back(val);  // now we will never push NULL
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteDb::insertRows(std::string sql, 
+    const std::vector<std::vector<double> >& rows) {
+  execute("BEGIN TRANSACTION");
+  try {
+    SqliteCursor cursor(*this, sql);
+    std::vector<std::vector<double> >::const_iterator row;
+    for(row = rows.begin(); row != rows.end(); ++row){
+      for(int i = 0; i < int((*row).size()); ++i){
+        cursor.bind(i + 1, (*row)[i]);
       }
-      results.push_back(values);
-    } 
+      cursor.next();
+      cursor.reset();
+    }
+  } catch ( ... ) {
+    sqlite3_exec(db_, "ROLLBACK", 0, 0, 0);
+    throw;
+  }
+  execute("COMMIT");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+sqlite3_stmt* SqliteDb::acquire(std::string sql) {
+  open();
+  std::map<std::string, sqlite3_stmt*>::iterator it = stmts_.find(sql);
+  if( it != stmts_.end() ){
+    // the cursor owns the statement until it is released
+    sqlite3_stmt* statement = it->second;
+    stmts_.erase(it);
+    return statement;
+  }
+  sqlite3_stmt* statement = NULL;
+  check(sqlite3_prepare_v2(db_, sql.c_str(), -1, &statement, 0), sql);
+  if( statement == NULL ){
+    throw CycIOException("SQL error: " + sql + " is not a statement");
+  }
+  return statement;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteDb::release(std::string sql, sqlite3_stmt* statement) {
+  if( !isOpen_ || sqlite3_db_handle(statement) != db_ ){
+    // the database was closed under the cursor
+    sqlite3_finalize(statement);
+    return;
+  }
+  sqlite3_reset(statement);
+  sqlite3_clear_bindings(statement);
+  if( stmts_.count(sql) == 0 && stmts_.size() < MAX_CACHED_STMTS ){
+    stmts_.insert(std::make_pair(sql, statement));
+  } else {
     sqlite3_finalize(statement);
   }
+}
 
-  // collect errors
-  std::string error = sqlite3_errmsg(db_);
-  if(error != "not an error") {
-    throw CycIOException("SQL error: " + sql + " " + error);
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteDb::check(int rc, std::string sql) {
+  if( rc != SQLITE_OK && rc != SQLITE_ROW && rc != SQLITE_DONE ) {
+    throw CycIOException("SQL error: " + sql + " " + sqlite3_errmsg(db_));
   }
+}
 
-  return results;  
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteDb::clearCache() {
+  std::map<std::string, sqlite3_stmt*>::iterator it;
+  for(it = stmts_.begin(); it != stmts_.end(); ++it){
+    sqlite3_finalize(it->second);
+  }
+  stmts_.clear();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+SqliteCursor::SqliteCursor(SqliteDb& db, std::string sql) :
+  db_(db),
+  sql_(sql),
+  statement_(db.acquire(sql)) {
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+SqliteCursor::~SqliteCursor() {
+  db_.release(sql_, statement_);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteCursor::bind(int i, int val) {
+  db_.check(sqlite3_bind_int(statement_, i, val), sql_);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteCursor::bind(int i, double val) {
+  db_.check(sqlite3_bind_double(statement_, i, val), sql_);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteCursor::bind(int i, std::string val) {
+  db_.check(sqlite3_bind_text(statement_, i, val.c_str(), val.size(), 
+        SQLITE_TRANSIENT), sql_);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+bool SqliteCursor::next() {
+  int rc = sqlite3_step(statement_);
+  db_.check(rc, sql_);
+  return rc == SQLITE_ROW;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void SqliteCursor::reset() {
+  sqlite3_reset(statement_);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+int SqliteCursor::columns() {
+  return sqlite3_column_count(statement_);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+int SqliteCursor::getInt(int i) {
+  return sqlite3_column_int(statement_, i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+double SqliteCursor::getDouble(int i) {
+  return sqlite3_column_double(statement_, i);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+std::string SqliteCursor::getText(int i) {
+  const char* ptr = (const char*)sqlite3_column_text(statement_, i);
+  return ptr ? std::string(ptr) : std::string("");
+}
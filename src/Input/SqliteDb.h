@@ -2,12 +2,15 @@
 #if !defined(_SQLITEDB_H)
 #define _SQLITEDB_H
 
+#include <map>
 #include <vector>
 #include <string>
 #include <sqlite3.h>
 
 typedef std::vector<std::string> StrList;
 
+class SqliteCursor;
+
 class SqliteDb {
   public:
 
@@ -25,7 +28,31 @@ class SqliteDb {
 
     std::vector<StrList> query(std::string cmd);
 
+    /**
+       executes an insert statement once per row, all in one transaction. 
+       Each row's values are bound to the statement's parameters in order. 
+       If any row fails, none of them are inserted. 
+
+       @param sql the statement, with one ? parameter per value
+       @param rows the values for each row
+     */
+    void insertRows(std::string sql, 
+        const std::vector<std::vector<double> >& rows);
+
   private:
+    friend class SqliteCursor;
+
+    /// a prepared statement for the sql, from the cache if there is one
+    sqlite3_stmt* acquire(std::string sql);
+
+    /// returns a statement to the cache, reset and ready for reuse
+    void release(std::string sql, sqlite3_stmt* statement);
+
+    /// throws a CycIOException unless rc is a success code
+    void check(int rc, std::string sql);
+
+    /// finalizes every cached statement
+    void clearCache();
 
     sqlite3* db_;
 
@@ -34,6 +61,52 @@ class SqliteDb {
     std::string path_;
 
     bool overwrite_;
+
+    /// the prepared statements not in use, by their sql
+    std::map<std::string, sqlite3_stmt*> stmts_;
+};
+
+/**
+   A cursor over the rows of one statement. The statement is prepared once 
+   per SqliteDb and reused by later cursors with the same sql. The columns 
+   are read as their own types, without a conversion to text. A cursor must 
+   not outlive its database. 
+ */
+class SqliteCursor {
+  public:
+
+    SqliteCursor(SqliteDb& db, std::string sql);
+
+    ~SqliteCursor();
+
+    /// binds a value to the parameter at index i, counting from 1
+    void bind(int i, int val);
+    void bind(int i, double val);
+    void bind(int i, std::string val);
+
+    /// steps to the next row, returning false when there are no more
+    bool next();
+
+    /// starts the statement over, keeping the bound values
+    void reset();
+
+    /// the number of columns in each row
+    int columns();
+
+    /// the value in column i of the current row, counting from 0
+    int getInt(int i);
+    double getDouble(int i);
+    std::string getText(int i);
+
+  private:
+    SqliteCursor(const SqliteCursor&);
+    SqliteCursor& operator=(const SqliteCursor&);
+
+    SqliteDb& db_;
+
+    std::string sql_;
+
+    sqlite3_stmt* statement_;
 };
 
 #endif
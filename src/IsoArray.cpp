@@ -0,0 +1,104 @@
+/*! \file IsoArray.cpp
+    \brief Implements the IsoDict and IsoArray classes used by the Generic Repository
+    \author Kathryn D. Huff
+ */
+#include "IsoArray.h"
+
+using namespace std;
+
+boost::mutex IsoDict::mutex_;
+vector<Iso> IsoDict::isos_;
+map<Iso, int> IsoDict::index_;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoDict::index(Iso tope){
+  boost::mutex::scoped_lock lock(mutex_);
+  map<Iso, int>::iterator found = index_.find(tope);
+  if( found != index_.end() ){
+    return found->second;
+  }
+  int i = isos_.size();
+  isos_.push_back(tope);
+  index_.insert(make_pair(tope, i));
+  return i;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoDict::find(Iso tope){
+  boost::mutex::scoped_lock lock(mutex_);
+  map<Iso, int>::const_iterator found = index_.find(tope);
+  return found == index_.end() ? -1 : found->second;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Iso IsoDict::iso(int i){
+  boost::mutex::scoped_lock lock(mutex_);
+  return isos_[i];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoDict::size(){
+  boost::mutex::scoped_lock lock(mutex_);
+  return isos_.size();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoArray::IsoArray(){
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoArray::IsoArray(const IsoConcMap& vals){
+  // number the isotopes under one lock, rather than one per isotope
+  vector<int> idx;
+  idx.reserve(vals.size());
+  int n;
+  {
+    boost::mutex::scoped_lock lock(IsoDict::mutex_);
+    IsoConcMap::const_iterator it;
+    for(it = vals.begin(); it != vals.end(); ++it){
+      std::map<Iso, int>::iterator found = IsoDict::index_.find(it->first);
+      if( found == IsoDict::index_.end() ){
+        found = IsoDict::index_.insert(make_pair(it->first,
+              int(IsoDict::isos_.size()))).first;
+        IsoDict::isos_.push_back(it->first);
+      }
+      idx.push_back(found->second);
+    }
+    n = IsoDict::isos_.size();
+  }
+  vals_.assign(n, 0);
+  mask_.assign(n, 0);
+  IsoConcMap::const_iterator it;
+  int j = 0;
+  for(it = vals.begin(); it != vals.end(); ++it, ++j){
+    vals_[idx[j]] = it->second;
+    mask_[idx[j]] = 1;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void IsoArray::resize(int n){
+  if( n > int(vals_.size()) ){
+    vals_.resize(n, 0);
+    mask_.resize(n, 0);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double IsoArray::at(Iso tope) const {
+  // looking an isotope up never adds it to the dictionary
+  int i = IsoDict::find(tope);
+  return (i >= 0 && i < int(vals_.size()) && mask_[i]) ? vals_[i] : 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoConcMap IsoArray::map() const {
+  IsoConcMap to_ret;
+  boost::mutex::scoped_lock lock(IsoDict::mutex_);
+  for(int i=0; i < int(vals_.size()); ++i){
+    if( mask_[i] ){
+      to_ret.insert(make_pair(IsoDict::isos_[i], vals_[i]));
+    }
+  }
+  return to_ret;
+}
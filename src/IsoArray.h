@@ -0,0 +1,112 @@
+/*! \file IsoArray.h
+  \brief Declares the IsoDict and IsoArray classes used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_ISOARRAY_H)
+#define _ISOARRAY_H
+
+#include <map>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+#include "IsoVector.h"
+#include "MatTools.h"
+
+/**
+   @brief IsoDict numbers the isotopes seen in the simulation.
+
+   Each isotope is assigned the next dense index the first time it is seen,
+   and keeps that index for the rest of the simulation. The dictionary only
+   grows, so an index is never invalidated. It is shared by every component.
+ */
+class IsoDict {
+public:
+  /**
+     the dense index of an isotope, assigning one if it is new
+
+     @param tope the isotope
+     @return its index
+   */
+  static int index(Iso tope);
+
+  /**
+     the dense index of an isotope, without assigning one
+
+     @param tope the isotope
+     @return its index, or -1 if it hasn't been seen
+   */
+  static int find(Iso tope);
+
+  /**
+     the isotope at a dense index
+
+     @param i the index, less than size()
+     @return the isotope
+   */
+  static Iso iso(int i);
+
+  /// the number of isotopes seen so far
+  static int size();
+
+protected:
+  friend class IsoArray;
+
+  /// guards the dictionary
+  static boost::mutex mutex_;
+
+  /// the isotope at each index
+  static std::vector<Iso> isos_;
+
+  /// the index of each isotope
+  static std::map<Iso, int> index_;
+};
+
+/**
+   @brief IsoArray is a dense, IsoDict-indexed vector of isotopic values.
+
+   The values of absent isotopes are zero, and a parallel mask records which
+   isotopes are present, so an IsoArray converts back to exactly the map it
+   was made from. The values are contiguous, for the straight-line kernels
+   in MatTools.
+ */
+class IsoArray {
+public:
+  /// an empty array
+  IsoArray();
+
+  /**
+     an array from a map of isotopes to values
+
+     @param vals the isotopes and their values
+   */
+  IsoArray(const IsoConcMap& vals);
+
+  /// the number of entries, present or not
+  int size() const {return vals_.size();};
+
+  /// grows the array to n entries, the new ones absent
+  void resize(int n);
+
+  /// the values, in place
+  double* vals() {return vals_.empty() ? NULL : &vals_[0];};
+  const double* vals() const {return vals_.empty() ? NULL : &vals_[0];};
+
+  /// the presence mask, in place
+  char* mask() {return mask_.empty() ? NULL : &mask_[0];};
+  const char* mask() const {return mask_.empty() ? NULL : &mask_[0];};
+
+  /// the value of an isotope, or zero if it is absent or unknown
+  double at(Iso tope) const;
+
+  /// converts the present entries back to a map
+  IsoConcMap map() const;
+
+protected:
+  /// the value at each index
+  std::vector<double> vals_;
+
+  /// nonzero where the isotope at that index is present
+  std::vector<char> mask_;
+};
+
+#endif
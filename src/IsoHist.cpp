@@ -0,0 +1,167 @@
+/*! \file IsoHist.cpp
+    \brief Implements the IsoHist class used by the Generic Repository
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <limits>
+
+#include "IsoHist.h"
+
+using namespace std;
+
+const double IsoHist::absent_ = numeric_limits<double>::quiet_NaN();
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoHist::IsoHist() :
+  t0_(0),
+  n_set_(0),
+  version_(0)
+{
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoHist::index(int the_time) const {
+  int i = the_time - t0_;
+  return (i >= 0 && i < int(set_.size())) ? i : -1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool IsoHist::has(int the_time) const {
+  int i = index(the_time);
+  return i >= 0 && set_[i];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoHist::col(Iso tope) const {
+  vector<Iso>::const_iterator it = lower_bound(isos_.begin(), isos_.end(), tope);
+  return (it != isos_.end() && *it == tope) ? int(it - isos_.begin()) : -1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const double* IsoHist::row(int the_time) const {
+  int i = index(the_time);
+  if( i < 0 || !set_[i] || isos_.empty() ){
+    return NULL;
+  }
+  return &data_[i*isos_.size()];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double IsoHist::at(int the_time, Iso tope) const {
+  const double* vals = row(the_time);
+  int j = col(tope);
+  if( vals == NULL || j < 0 || absent(vals[j]) ){
+    return 0;
+  }
+  return vals[j];
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double IsoHist::mass(int the_time) const {
+  int i = index(the_time);
+  return (i >= 0 && set_[i]) ? mass_[i] : 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+IsoConcMap IsoHist::map(int the_time) const {
+  IsoConcMap to_ret;
+  const double* vals = row(the_time);
+  if( vals != NULL ){
+    for(int j=0; j < int(isos_.size()); ++j){
+      if( !absent(vals[j]) ){
+        to_ret.insert(to_ret.end(), make_pair(isos_[j], vals[j]));
+      }
+    }
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+pair<IsoVector, double> IsoHist::vec(int the_time) const {
+  if( !has(the_time) ){
+    return pair<IsoVector, double>();
+  }
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  const double* vals = row(the_time);
+  if( vals != NULL ){
+    for(int j=0; j < int(isos_.size()); ++j){
+      if( !absent(vals[j]) ){
+        (*comp)[isos_[j]] = vals[j];
+      }
+    }
+  }
+  return make_pair(IsoVector(comp), mass(the_time));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void IsoHist::set(int the_time, const IsoConcMap& vals, double mass){
+  IsoConcMap::const_iterator it;
+  for(it = vals.begin(); it != vals.end(); ++it){
+    addCol(it->first);
+  }
+  int i = addRow(the_time);
+  int n = isos_.size();
+  fill(data_.begin() + i*n, data_.begin() + (i+1)*n, absent_);
+  for(it = vals.begin(); it != vals.end(); ++it){
+    data_[i*n + col(it->first)] = it->second;
+  }
+  mass_[i] = mass;
+  if( !set_[i] ){
+    set_[i] = true;
+    ++n_set_;
+  }
+  ++version_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void IsoHist::set(int the_time, const pair<IsoVector, double>& vec_pair){
+  IsoConcMap vals;
+  CompMapPtr comp = vec_pair.first.comp();
+  if( comp ){
+    vals.insert(comp->begin(), comp->end());
+  }
+  set(the_time, vals, vec_pair.second);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoHist::addRow(int the_time){
+  int n = isos_.size();
+  if( set_.empty() ){
+    t0_ = the_time;
+  } else if( the_time < t0_ ){
+    // prepend the missing rows
+    int shift = t0_ - the_time;
+    data_.insert(data_.begin(), shift*n, absent_);
+    mass_.insert(mass_.begin(), shift, 0);
+    set_.insert(set_.begin(), shift, false);
+    t0_ = the_time;
+  }
+  int i = the_time - t0_;
+  if( i >= int(set_.size()) ){
+    data_.resize((i+1)*n, absent_);
+    mass_.resize(i+1, 0);
+    set_.resize(i+1, false);
+  }
+  return i;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int IsoHist::addCol(Iso tope){
+  vector<Iso>::iterator it = lower_bound(isos_.begin(), isos_.end(), tope);
+  int j = it - isos_.begin();
+  if( it != isos_.end() && *it == tope ){
+    return j;
+  }
+  // rare, the isotope set settles quickly, so restride the whole history
+  int n = isos_.size();
+  int n_rows = set_.size();
+  vector<double> data(n_rows*(n+1), absent_);
+  for(int i=0; i < n_rows; ++i){
+    copy(data_.begin() + i*n, data_.begin() + i*n + j, data.begin() + i*(n+1));
+    copy(data_.begin() + i*n + j, data_.begin() + (i+1)*n,
+        data.begin() + i*(n+1) + j + 1);
+  }
+  data_.swap(data);
+  isos_.insert(it, tope);
+  return j;
+}
@@ -0,0 +1,154 @@
+/*! \file IsoHist.h
+  \brief Declares the IsoHist class used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_ISOHIST_H)
+#define _ISOHIST_H
+
+#include <vector>
+#include <utility>
+
+#include "IsoVector.h"
+#include "MatTools.h"
+
+/**
+   @brief IsoHist is a dense, timestep-indexed history of isotopic values.
+
+   Each timestep is a row and each isotope is a column. The rows are stored
+   contiguously, in timestep order, starting at the first timestep recorded.
+   The isotope columns are kept sorted and are shared by every row, so the
+   isotope keys are stored once rather than once per timestep. An isotope
+   that was not present at a timestep holds a NaN, so a row converts back
+   to exactly the map it was set from. Each row also has an optional mass,
+   for histories of normalized IsoVectors.
+
+   Rows may be read in place through row(), without copying.
+ */
+class IsoHist {
+public:
+  /**
+     Default constructor, an empty history
+   */
+  IsoHist();
+
+  /// returns true if no row has been set
+  bool empty() const {return n_set_ == 0;};
+
+  /// returns true if the row at the_time has been set
+  bool has(int the_time) const;
+
+  /// a counter that changes every time a row is set
+  unsigned long version() const {return version_;};
+
+  /// the isotopes of the columns, sorted
+  const std::vector<Iso>& isos() const {return isos_;};
+
+  /// the number of isotope columns
+  int n_isos() const {return isos_.size();};
+
+  /**
+     the column of an isotope
+
+     @param tope the isotope
+     @return the column index, or -1 if the isotope has no column
+   */
+  int col(Iso tope) const;
+
+  /**
+     the values at a time, one per column, in place. Absent isotopes are NaN.
+     The pointer is invalidated by the next set().
+
+     @param the_time the timestep to query
+     @return the row, or NULL if the row has not been set
+   */
+  const double* row(int the_time) const;
+
+  /**
+     the value of an isotope at a time
+
+     @param the_time the timestep to query
+     @param tope the isotope to query
+     @return the value, or zero if the row or isotope is absent
+   */
+  double at(int the_time, Iso tope) const;
+
+  /**
+     the mass of the row at a time
+
+     @param the_time the timestep to query
+     @return the mass, or zero if the row is absent
+   */
+  double mass(int the_time) const;
+
+  /**
+     the row at a time, as a map
+
+     @param the_time the timestep to query
+     @return the map of isotopes to values, empty if the row is absent
+   */
+  IsoConcMap map(int the_time) const;
+
+  /**
+     the row at a time, as an IsoVector and mass
+
+     @param the_time the timestep to query
+     @return the IsoVector and mass, or an empty pair if the row is absent
+   */
+  std::pair<IsoVector, double> vec(int the_time) const;
+
+  /**
+     sets the row at a time from a map of isotopes to values
+
+     @param the_time the timestep to set
+     @param vals the isotopes and their values
+     @param mass the mass to record with the row
+   */
+  void set(int the_time, const IsoConcMap& vals, double mass=0);
+
+  /**
+     sets the row at a time from the composition of an IsoVector
+
+     @param the_time the timestep to set
+     @param vec_pair the IsoVector and its mass
+   */
+  void set(int the_time, const std::pair<IsoVector, double>& vec_pair);
+
+  /// returns true if the value is the marker for an absent isotope
+  static bool absent(double val) {return val != val;};
+
+protected:
+  /// the index of the row for the_time, or -1 if it is out of range
+  int index(int the_time) const;
+
+  /// makes room for a row at the_time, returning its index
+  int addRow(int the_time);
+
+  /// adds a column for the isotope, if there isn't one, and returns it
+  int addCol(Iso tope);
+
+  /// the marker value for an absent isotope
+  static const double absent_;
+
+  /// the timestep of the first row
+  int t0_;
+
+  /// the isotopes of the columns, sorted
+  std::vector<Iso> isos_;
+
+  /// the row-major values, n_rows x n_isos
+  std::vector<double> data_;
+
+  /// the mass of each row
+  std::vector<double> mass_;
+
+  /// whether each row has been set
+  std::vector<bool> set_;
+
+  /// the number of rows that have been set
+  int n_set_;
+
+  /// incremented by every set()
+  unsigned long version_;
+};
+
+#endif
@@ -16,28 +16,17 @@
 using namespace std;
 using boost::lexical_cast;
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-LumpedNuclide::LumpedNuclide() : 
-  t_t_(0),
-  Pe_(0),
-  porosity_(0),
-  formulation_(LAST_FORMULATION_TYPE)
+LumpedNuclide::LumpedNuclide()
 { 
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
 
-  t_t_ = 0;
-  v_ = 0;
-  Pe_ = 0;
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-LumpedNuclide::LumpedNuclide(QueryEngine* qe):
-  t_t_(0),
-  Pe_(0),
-  porosity_(0),
-  formulation_(LAST_FORMULATION_TYPE)
+LumpedNuclide::LumpedNuclide(QueryEngine* qe)
 { 
 
   set_geom(GeometryPtr(new Geometry()));
@@ -48,17 +37,25 @@ LumpedNuclide::LumpedNuclide(QueryEngine* qe):
   initModuleMembers(qe);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LumpedNuclide::LumpedNuclide(const LumpedNuclide& src)
+{
+  last_updated_=0;
+  copy_from(src);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 LumpedNuclide::~LumpedNuclide(){
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LumpedNuclide::initModuleMembers(QueryEngine* qe){
-  t_t_ = lexical_cast<double>(qe->getElementContent("transit_time"));
-  v_ = lexical_cast<double>(qe->getElementContent("advective_velocity"));
-  porosity_ = lexical_cast<double>(qe->getElementContent("porosity"));
+  Params& params = params_.write();
+  params.t_t = lexical_cast<double>(qe->getElementContent("transit_time"));
+  params.v = lexical_cast<double>(qe->getElementContent("advective_velocity"));
+  params.porosity = lexical_cast<double>(qe->getElementContent("porosity"));
 
-  Pe_=NULL;
+  params.Pe=NULL;
 
   list<string> choices;
   list<string>::iterator it;
@@ -70,14 +67,14 @@ void LumpedNuclide::initModuleMembers(QueryEngine* qe){
   string formulation_string;
   for( it=choices.begin(); it!=choices.end(); it++){
     if (formulation_qe->nElementsMatchingQuery(*it) == 1){
-      formulation_=enumerateFormulation(*it);
+      params.formulation=enumerateFormulation(*it);
       formulation_string=(*it);
     }
   }
   QueryEngine* ptr = formulation_qe->queryElement(formulation_string);
-  switch(formulation_){
+  switch(params.formulation){
     case DM :
-      Pe_ = lexical_cast<double>(ptr->getElementContent("peclet"));
+      params.Pe = lexical_cast<double>(ptr->getElementContent("peclet"));
       break;
     case EM :
       break;
@@ -85,7 +82,7 @@ void LumpedNuclide::initModuleMembers(QueryEngine* qe){
       break;
     default:
       string err = "The formulation type '"; 
-      err += formulation_;
+      err += formulation();
       err += "' is not supported.";
       throw CycException(err);
       LOG(LEV_ERROR,"GRLNuc") << err;
@@ -98,22 +95,26 @@ void LumpedNuclide::initModuleMembers(QueryEngine* qe){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 NuclideModelPtr LumpedNuclide::copy(const NuclideModel& src){
   const LumpedNuclide* src_ptr = dynamic_cast<const LumpedNuclide*>(&src);
+  copy_from(*src_ptr);
+
+  return shared_from_this();
+}
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void LumpedNuclide::copy_from(const LumpedNuclide& src){
   set_last_updated(TI->time());
-  set_t_t(src_ptr->t_t());
-  set_Pe(src_ptr->Pe());
-  set_porosity(src_ptr->porosity());
-  set_formulation(src_ptr->formulation());
+  // the parameters are shared, not copied
+  params_ = src.params_;
 
-  // copy the geometry AND the centroid, it should be reset later.
-  set_geom(geom_->copy(src_ptr->geom(), src_ptr->geom()->centroid()));
+  // the geometry is the template's until the component is placed, and the
+  // histories are made by the first update
+  set_geom(src.geom());
 
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  iso_masses_ = IsoMassMap();
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
-  update(TI->time());
-
-  return shared_from_this();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -135,7 +136,7 @@ void LumpedNuclide::absorb(mat_rsrc_ptr matToAdd) {
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRLNuc") << "LumpedNuclide is absorbing material: ";
   matToAdd->print();
-  wastes_.push_back(matToAdd);
+  absorb_mat(matToAdd);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -145,7 +146,7 @@ mat_rsrc_ptr LumpedNuclide::extract(const CompMapPtr comp_to_rem, double kg_to_r
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRLNuc") << "LumpedNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
-  mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  mat_rsrc_ptr to_ret = extract_mat(comp_to_rem, kg_to_rem);
   update(TI->time());
   return to_ret;
 }
@@ -183,46 +184,15 @@ IsoConcMap LumpedNuclide::dirichlet_bc(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ConcGradMap LumpedNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
-  ConcGradMap to_ret;
   IsoConcMap c_int = conc_hist(last_updated());
   Radius r_int = geom()->radial_midpoint();
-
-  int iso;
-  IsoConcMap::iterator it;
-  for( it=c_int.begin(); it!=c_int.end(); ++it){
-    iso=(*it).first;
-    if( c_ext.count(iso) != 0 ) {
-      // in both
-      to_ret[iso] = calc_conc_grad(c_ext[iso], c_int[iso], r_ext, r_int);
-    } else {
-      // in c_int only
-      to_ret[iso] = calc_conc_grad(0, c_int[iso], r_ext, r_int);
-    }
-  }
-  for( it=c_ext.begin(); it!=c_ext.end(); ++it){
-    iso = (*it).first;
-    if( c_int.count(iso) == 0) {
-      // in c_ext only
-      to_ret[iso] = calc_conc_grad(c_ext[iso], 0, r_ext, r_int);
-    }
-  }
-  return to_ret;
+  return calc_conc_grads(c_ext, c_int, 1, r_ext, r_int);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoFluxMap LumpedNuclide::cauchy_bc(IsoConcMap c_ext, Radius r_ext){
-  IsoFluxMap to_ret;
-  ConcGradMap neumann = neumann_bc(c_ext, r_ext);
-
-  ConcGradMap::iterator it;
-  Iso iso;
-  Elem elem;
-  for( it = neumann.begin(); it!=neumann.end(); ++it){
-    iso = (*it).first;
-    elem = iso/1000;
-    to_ret.insert(make_pair(iso, -mat_table_->D(elem)*(*it).second + shared_from_this()->dirichlet_bc(iso)*v()));
-  }
-  return to_ret;
+  // -D dC/dx + v_xC = v_x C
+  return calc_fluxes(neumann_bcs(c_ext, r_ext), dirichlet_bcs(), v());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -263,7 +233,7 @@ void LumpedNuclide::set_Pe(double Pe){
     LOG(LEV_ERROR,"GRDRNuc") << msg_ss.str();;
     throw CycRangeException(msg_ss.str());
   } else {
-    Pe_ = Pe;
+    params_.write().Pe = Pe;
   }
   MatTools::validate_finite_pos((Pe));
 }
@@ -282,7 +252,7 @@ void LumpedNuclide::set_porosity(double porosity){
     throw CycRangeException(msg_ss.str());
   }
 
-  porosity_ = porosity;
+  params_.write().porosity = porosity;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -305,10 +275,10 @@ void LumpedNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr> mats){
   IsoConcMap to_ret;
 
   pair<IsoVector, double> sum_pair;
-  sum_pair = vec_hist_[the_time];
+  sum_pair = vec_hist_.vec(the_time);
   IsoConcMap C_0 = MatTools::comp_to_conc_map(sum_pair.first.comp(), sum_pair.second, V_f());
 
-  switch(formulation_){
+  switch(formulation()){
     case DM :
       to_ret = C_DM(C_0, the_time);
       break;
@@ -320,14 +290,14 @@ void LumpedNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr> mats){
       break;
     default:
       string err = "The formulation type '"; 
-      err += formulation_;
+      err += formulation();
       err += "' is not supported.";
       throw CycException(err);
       LOG(LEV_ERROR,"GRLNuc") << err;
       break;
   }
   set_last_updated(the_time);
-  conc_hist_[the_time] = to_ret;
+  conc_hist_.set(the_time, to_ret);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -354,13 +324,13 @@ IsoConcMap LumpedNuclide::C_PFM(IsoConcMap C_0, int the_time){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void LumpedNuclide::update_vec_hist(int the_time){
-  vec_hist_[the_time] = MatTools::sum_mats(wastes_);
+  set_vec_hist(the_time);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-void LumpedNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
+void LumpedNuclide::update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters){
 
-  std::vector<NuclideModelPtr>::iterator daughter;
+  std::vector<NuclideModelPtr>::const_iterator daughter;
   
   IsoConcMap conc;
   Volume vol;
@@ -368,7 +338,7 @@ void LumpedNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> d
   Volume vol_sum;
   
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
-    conc = (*daughter)->dirichlet_bc();
+    conc = (*daughter)->dirichlet_bcs();
     vol = (*daughter)->geom()->volume();
     //scaled_conc_sum += conc * vol;
     //vol_sum += vol;
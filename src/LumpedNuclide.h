@@ -12,6 +12,8 @@
 #include <string>
 
 #include "NuclideModel.h"
+#include "PoolAlloc.h"
+#include "SharedParams.h"
 
 enum FormulationType{
   DM, 
@@ -50,7 +52,7 @@ typedef boost::shared_ptr<LumpedNuclide> LumpedNuclidePtr;
    disposal system such as the Waste Form, Waste Package, Buffer, Near Field,
    Far Field, and Envrionment.
  */
-class LumpedNuclide : public NuclideModel {
+class LumpedNuclide : public NuclideModel, public PoolAlloc<LumpedNuclide> {
 private: 
   
   /**
@@ -67,18 +69,37 @@ private:
    */
   LumpedNuclide(QueryEngine* qe);
 
+  /**
+     Constructs a copy of a template model, sharing its parameters, without 
+     the default geometry made only to be replaced. Use create(src).
+
+     @param src the template model to copy
+   */
+  LumpedNuclide(const LumpedNuclide& src);
+
+  /// sets up this model as a copy of src, for copy() and create(src)
+  void copy_from(const LumpedNuclide& src);
+
 public:
   /**
      A constructor for the Lumped Nuclide Model that returns a shared pointer.
     */
-  static LumpedNuclidePtr create (){ LumpedNuclidePtr to_ret = LumpedNuclidePtr(new LumpedNuclide()); to_ret->set_formulation(DM); return to_ret;};
+  static LumpedNuclidePtr create (){ LumpedNuclidePtr to_ret = share(new LumpedNuclide()); to_ret->set_formulation(DM); return to_ret;};
 
   /**
      A constructor for the Lumped Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static LumpedNuclidePtr create (QueryEngine* qe){ return LumpedNuclidePtr(new LumpedNuclide(qe)); };
+  static LumpedNuclidePtr create (QueryEngine* qe){ return share(new LumpedNuclide(qe)); };
+
+  /**
+     A constructor for the Lumped Nuclide Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static LumpedNuclidePtr create(const LumpedNuclide& src){ return share(new LumpedNuclide(src)); };
 
   /**
      Virtual destructor deletes datamembers that are object pointers.
@@ -179,7 +200,7 @@ public:
   virtual IsoFluxMap cauchy_bc(IsoConcMap c_ext, Radius r_ext);
 
   /// Returns the formulation of the concentration relationship
-  const FormulationType formulation() const {return formulation_;};
+  const FormulationType formulation() const {return params_->formulation;};
 
   /** Returns the FormulationType corresponding to the string
    * 
@@ -189,33 +210,33 @@ public:
   FormulationType enumerateFormulation(std::string formulation);
 
   /// Sets the formulation of the concentration relationship
-  void set_formulation(std::string formulation){formulation_ = enumerateFormulation(formulation);};
+  void set_formulation(std::string formulation){params_.write().formulation = enumerateFormulation(formulation);};
 
   /// Sets the formulation of the concentration relationship
-  void set_formulation(FormulationType formulation){formulation_ = formulation;};
+  void set_formulation(FormulationType formulation){params_.write().formulation = formulation;};
 
-  /// Sets the porosity_ variable, the percent of the permeable porous medium.
+  /// Sets the porosity variable, the percent of the permeable porous medium.
   void set_porosity(double porosity);
 
   /// Sets the peclet_ variable, the ratio of advective to diffusive transport.
   void set_Pe(double Pe);
 
-  /// Sets the transit time, t_t_, variable of the radioactive tracer through the cell [s?] 
-  void set_t_t(double t_t){t_t_ = t_t;};
+  /// Sets the transit time, t_t, variable of the radioactive tracer through the cell [s?] 
+  void set_t_t(double t_t){params_.write().t_t = t_t;};
 
   /// Returns the transit time of the radioactive tracer through the cell [s?] 
-  const double t_t() const {return t_t_;};
+  const double t_t() const {return params_->t_t;};
 
   /// Returns the peclet number of the component [-]
-  const double Pe() const {return Pe_;};
+  const double Pe() const {return params_->Pe;};
 
   /**
     The advective velocity through this component. [m/s] 
    */
-  const double v() const {return v_;};
+  const double v() const {return params_->v;};
 
   /// The porosity of the permeable porous mediuam of theis component. [%]
-  const double porosity() const {return porosity_;};
+  const double porosity() const {return params_->porosity;};
 
   /// Gets the total volume
   double V_T();
@@ -259,7 +280,7 @@ public:
      @param daughter nuclide_model of an internal component. there may be many.
      
     */
-  void update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters); 
+  void update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters); 
 
   /** 
      Updates the contained vector
@@ -285,25 +306,34 @@ public:
 
 
 protected:
-  /**
-    The advective velocity through this component [m/s]
-   */
-  double v_;
-  /**
-   * The name of the lumped parameter model formulation. This can be 
-   * the Exponential Model (EM), Piston Flow Model (PFM), 
-   * or the Dispersion Model(DM).
-   */
-  FormulationType formulation_;
+  /// the parameters of a LumpedNuclide, which its copies share
+  struct Params {
+    /// Constructor, for the default parameters
+    Params() : v(0), formulation(LAST_FORMULATION_TYPE), t_t(0), Pe(0), 
+      porosity(0) {};
+
+    /// The advective velocity through this component [m/s]
+    double v;
+
+    /**
+     * The name of the lumped parameter model formulation. This can be 
+     * the Exponential Model (EM), Piston Flow Model (PFM), 
+     * or the Dispersion Model(DM).
+     */
+    FormulationType formulation;
+
+    /// The transit time of a radioactive tracer through the cell
+    double t_t;
 
-  /// The transit time of a radioactive tracer through the cell
-  double t_t_;
+    /// The dimensionless mass diffusion Peclet number of the medium [-].
+    double Pe;
 
-  /// The dimensionless mass diffusion Peclet number of the medium [-].
-  double Pe_;
+    /// The porosity of the permeable porous medium
+    double porosity;
+  };
 
-  /// The porosity of the permeable porous medium
-  double porosity_;
+  /// the parameters, shared with the template until one is set
+  SharedParams<Params> params_;
 
   /// the current conc map at the inner boundary
   IsoConcMap C_0_;
@@ -6,15 +6,52 @@
 #include "Logger.h"
 #include <fstream>
 #include <vector>
+#include <cmath>
 #include <time.h>
+#include <boost/lexical_cast.hpp>
 
 #include "CycException.h"
 #include "LumpedThermal.h"
 
 using namespace std;
+using boost::lexical_cast;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LumpedThermal::LumpedThermal() :
+  specific_power_(0),
+  half_life_(0)
+{
+  temperature_ = 0;
+  temp_hist_ = TempHist();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LumpedThermal::LumpedThermal(QueryEngine* qe) :
+  specific_power_(0),
+  half_life_(0)
+{
+  temperature_ = 0;
+  temp_hist_ = TempHist();
+  initModuleMembers(qe);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+LumpedThermal::LumpedThermal(const LumpedThermal& src) :
+  specific_power_(src.specific_power_),
+  half_life_(src.half_life_)
+{
+  copy_limits(src);
+  temperature_ = src.temperature_;
+}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LumpedThermal::initModuleMembers(QueryEngine* qe){
+  set_specific_power(lexical_cast<double>(qe->getElementContent("specific_power")));
+  set_half_life(lexical_cast<double>(qe->getElementContent("half_life")));
+  // the temperature history is kept whole unless it is limited
+  if( qe->nElementsMatchingQuery("hist_limit") == 1 ){
+    set_hist_limit(lexical_cast<int>(qe->getElementContent("hist_limit")));
+  }
   LOG(LEV_DEBUG2,"GRSThm") << "The LumpedThermal Class init(cur) function has been called";;
 }
 
@@ -27,6 +64,19 @@ LumpedThermalPtr LumpedThermal::deepCopy(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void LumpedThermal::copy(ThermalModelPtr src){
+  LumpedThermalPtr src_ptr = boost::dynamic_pointer_cast<LumpedThermal>(src);
+  if( !src_ptr ){
+    string err = "A LumpedThermal model can't be copied from a ";
+    err += src->name();
+    err += " model.";
+    LOG(LEV_ERROR,"GRSThm") << err;
+    throw CycException(err);
+  }
+  set_specific_power(src_ptr->specific_power());
+  set_half_life(src_ptr->half_life());
+  copy_limits(*src_ptr);
+  temperature_ = src_ptr->temperature_;
+  temp_hist_ = TempHist();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -37,19 +87,42 @@ void LumpedThermal::print(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void LumpedThermal::transportHeat(int time){
-  // This will transport the heat through the component at hand. 
-  // It should send some kind of heat object or reset the temperatures. 
+  // the temperature has already been set by the thermal field of the 
+  // repository, so it only needs recording
+  record_temp(time, temperature_);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 Temp LumpedThermal::peak_temp(){
-  TempHist::iterator start = temp_hist_.begin();
-  TempHist::iterator stop = temp_hist_.end();
-  TempHist::iterator max = max_element(start, stop);
-  return (*max).second;
+  return peak_temp_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 Temp LumpedThermal::temp(){
   return temperature_;
 }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double LumpedThermal::decay_const(){
+  return (half_life_ > 0) ? log(2.0)/half_life_ : 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void LumpedThermal::set_specific_power(double specific_power){
+  if( specific_power < 0 ){
+    string err = "The specific power of a LumpedThermal model can't be negative.";
+    LOG(LEV_ERROR,"GRSThm") << err;
+    throw CycRangeException(err);
+  }
+  specific_power_ = specific_power;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void LumpedThermal::set_half_life(double half_life){
+  if( half_life < 0 ){
+    string err = "The half life of a LumpedThermal model can't be negative.";
+    LOG(LEV_ERROR,"GRSThm") << err;
+    throw CycRangeException(err);
+  }
+  half_life_ = half_life;
+}
@@ -11,6 +11,7 @@
 
 
 #include "ThermalModel.h"
+#include "PoolAlloc.h"
 
 /// A shared pointer for the LumpedThermal object
 class LumpedThermal;
@@ -18,42 +19,64 @@ typedef boost::shared_ptr<LumpedThermal> LumpedThermalPtr;
 
 
 /** 
-   @brief LumpedThermal is a skeleton component model that does nothing.
+   @brief LumpedThermal is a thermal model with a single, homogeneous 
+   temperature throughout the component.
    
-   This disposal system component will do nothing. This Component is 
-   intended as a skeleton to guide the implementation of new Components. 
+   The temperature is set by the ThermalField of the repository, which 
+   superposes the heat of all of the emplaced waste, and is recorded in the 
+   temperature history at each transportHeat. 
+   
+   A waste form with a LumpedThermal model is a source of heat. Its power is 
+   its specific power times the mass it contains when it is emplaced, and 
+   decays with the given half life. 
    
    The LumpedThermal model can be used to represent components of the 
    disposal system such as the Waste Form, Waste Package, Buffer, Near Field,
    Far Field, and Envrionment.
  */
-class LumpedThermal : public ThermalModel {
+class LumpedThermal : public ThermalModel, public PoolAlloc<LumpedThermal> {
 private:
   /**
      Default constructor for the component class. Creates an empty component.
    */
-  LumpedThermal(){}; 
+  LumpedThermal(); 
 
   /**
      primary constructor reads input from XML node
      
      @param qe is the QueryEngine object containing intialization info
    */
-  LumpedThermal(QueryEngine* qe){};
+  LumpedThermal(QueryEngine* qe);
+
+  /**
+     Constructs a copy of a template model, with its parameters and limits 
+     but none of its records. Use create(src).
+
+     @param src the template model to copy
+   */
+  LumpedThermal(const LumpedThermal& src);
 
 public:
 
   /**
      A constructor for the Lumped Nuclide Model that returns a shared pointer.
     */
-  static ThermalModelPtr create(){ return ThermalModelPtr(new LumpedThermal()); };
+  static ThermalModelPtr create(){ return share(new LumpedThermal()); };
 
   /**
      A constructor for the Lumped Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static ThermalModelPtr create(QueryEngine* qe){ return ThermalModelPtr(new LumpedThermal(qe)); };
+  static ThermalModelPtr create(QueryEngine* qe){ return share(new LumpedThermal(qe)); };
+
+  /**
+     A constructor for the Lumped Thermal Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static ThermalModelPtr create(const LumpedThermal& src){ return share(new LumpedThermal(src)); };
 
   /** 
      Default destructor does nothing.
@@ -118,5 +141,42 @@ public:
    */
   virtual Temp temp();
 
+  /*----------------------------*/
+  /* This ThermalModel class    */
+  /* has the following members  */
+  /*----------------------------*/
+public:
+  /**
+     the power of the waste in this component when it is emplaced
+
+     @param mass the mass of the waste [kg]
+     @return the power [W]
+   */
+  Power power(double mass){return specific_power_*mass;};
+
+  /**
+     the decay constant of the power, zero if it doesn't decay [1/s]
+   */
+  double decay_const();
+
+  /// set the power of the waste per unit mass [W/kg]
+  void set_specific_power(double specific_power);
+
+  /// the power of the waste per unit mass [W/kg]
+  const double specific_power() const {return specific_power_;};
+
+  /// set the half life of the power, zero if it doesn't decay [s]
+  void set_half_life(double half_life);
+
+  /// the half life of the power, zero if it doesn't decay [s]
+  const double half_life() const {return half_life_;};
+
+protected:
+  /// the power of the waste per unit mass [W/kg]
+  double specific_power_;
+
+  /// the half life of the power, zero if it doesn't decay [s]
+  double half_life_;
+
 };
 #endif
@@ -4,11 +4,12 @@
  */
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 #include <deque>
 #include <time.h>
 #include <assert.h>
 
-
 #include "CycException.h"
 #include "Logger.h"
 #include "Timer.h"
@@ -22,7 +23,7 @@ pair<IsoVector, double> MatTools::sum_mats(deque<mat_rsrc_ptr> mats){
   IsoVector vec;
   CompMapPtr sum_comp = CompMapPtr(new CompMap(MASS));
   double kg = 0;
-  double mass_to_add;
+  double mat_kg;
 
   if( mats.size() != 0 ){ 
     CompMapPtr comp_to_add;
@@ -31,15 +32,16 @@ pair<IsoVector, double> MatTools::sum_mats(deque<mat_rsrc_ptr> mats){
     CompMap::const_iterator comp;
 
     for(mat = mats.begin(); mat != mats.end(); ++mat){ 
-      kg += (*mat)->mass(MassUnit(KG));
+      mat_kg = (*mat)->mass(MassUnit(KG));
+      kg += mat_kg;
       comp_to_add = (*mat)->isoVector().comp();
       comp_to_add->massify();
       for(comp = (*comp_to_add).begin(); comp != (*comp_to_add).end(); ++comp) {
         iso = comp->first;
         if(sum_comp->count(iso)!=0) {
-          (*sum_comp)[iso] = (*sum_comp)[iso] + (comp->second)*kg;
+          (*sum_comp)[iso] = (*sum_comp)[iso] + (comp->second)*mat_kg;
         } else { 
-          (*sum_comp)[iso] = (comp->second)*kg;
+          (*sum_comp)[iso] = (comp->second)*mat_kg;
         }
       }
     }
@@ -50,6 +52,24 @@ pair<IsoVector, double> MatTools::sum_mats(deque<mat_rsrc_ptr> mats){
   return make_pair(vec, kg);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double MatTools::add_masses(mat_rsrc_ptr mat, IsoMassMap& masses, double scale){
+  double kg = scale*mat->mass(MassUnit(KG));
+  CompMapPtr comp = mat->isoVector().comp();
+  if( !comp || kg == 0 ){
+    return 0;
+  }
+  comp->massify();
+
+  CompMap::const_iterator it;
+  IsoMassMap::iterator found;
+  for(it = comp->begin(); it != comp->end(); ++it){
+    found = masses.insert(make_pair(it->first, 0.0)).first;
+    found->second = max(0.0, found->second + (it->second)*kg);
+  }
+  return kg;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 mat_rsrc_ptr MatTools::extract(const CompMapPtr comp_to_rem, double kg_to_rem, deque<mat_rsrc_ptr>& mat_list){
   mat_rsrc_ptr left_over = mat_rsrc_ptr(new Material(comp_to_rem));
@@ -63,6 +83,82 @@ mat_rsrc_ptr MatTools::extract(const CompMapPtr comp_to_rem, double kg_to_rem, d
   return to_ret;
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+mat_rsrc_ptr MatTools::extract(const CompMapPtr comp_to_rem, double kg_to_rem, 
+    IsoMassMap& masses){
+  comp_to_rem->massify();
+  double tot = 0;
+  CompMap::const_iterator it;
+  for(it = comp_to_rem->begin(); it != comp_to_rem->end(); ++it){
+    tot += it->second;
+  }
+  IsoMassMap kgs_to_rem;
+  if( tot > 0 ){
+    for(it = comp_to_rem->begin(); it != comp_to_rem->end(); ++it){
+      kgs_to_rem.insert(kgs_to_rem.end(), 
+          make_pair(it->first, kg_to_rem*(it->second)/tot));
+    }
+  }
+  return extract(kgs_to_rem, masses);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+mat_rsrc_ptr MatTools::extract(const IsoMassMap& kgs_to_rem, IsoMassMap& masses){
+  // the relative shortfall tolerated, for roundoff in the requested masses
+  static const double tol = 1e-9;
+
+  // check everything before removing anything
+  IsoMassMap::const_iterator it;
+  IsoMassMap::iterator found;
+  for(it = kgs_to_rem.begin(); it != kgs_to_rem.end(); ++it){
+    validate_finite_pos(it->second);
+    found = masses.find(it->first);
+    double avail = (found != masses.end()) ? found->second : 0;
+    if( it->second - avail > tol*it->second ){
+      stringstream msg_ss;
+      msg_ss << "Cannot extract " << it->second << " kg of isotope " 
+        << it->first << ", only " << avail << " kg is contained.";
+      LOG(LEV_ERROR, "GRMatTl") << msg_ss.str();
+      throw CycRangeException(msg_ss.str());
+    }
+  }
+
+  IsoMassMap removed;
+  for(it = kgs_to_rem.begin(); it != kgs_to_rem.end(); ++it){
+    found = masses.find(it->first);
+    double kg = 0;
+    if( found != masses.end() ){
+      kg = min(it->second, found->second);
+      found->second -= kg;
+    }
+    removed.insert(removed.end(), make_pair(it->first, kg));
+  }
+  return mass_map_to_mat(removed);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+mat_rsrc_ptr MatTools::mass_map_to_mat(const IsoMassMap& masses){
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  double kg = 0;
+  IsoMassMap::const_iterator it;
+  for(it = masses.begin(); it != masses.end(); ++it){
+    if( it->second > 0 ){
+      (*comp)[it->first] = it->second;
+      kg += it->second;
+    }
+  }
+  if( kg > 0 ){
+    comp->normalize();
+  } else {
+    // an empty material still needs a composition
+    (*comp)[masses.empty() ? 92235 : masses.begin()->first] = 1;
+  }
+
+  mat_rsrc_ptr to_ret = mat_rsrc_ptr(new Material(comp));
+  to_ret->setQuantity(kg);
+  return to_ret;
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap MatTools::comp_to_conc_map(CompMapPtr comp, double mass, double vol){
   MatTools::validate_finite_pos(vol);
@@ -140,12 +236,112 @@ void MatTools::validate_finite_pos(double pos){
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-IsoConcMap MatTools::scaleConcMap(IsoConcMap C_0, double scalar){
-  double orig;
-  IsoConcMap::iterator it;
+IsoConcMap MatTools::scaleConcMap(const IsoConcMap& C_0, double scalar){
+  IsoConcMap to_ret;
+  IsoConcMap::const_iterator it;
   for(it = C_0.begin(); it != C_0.end(); ++it) { 
-    orig = C_0[(*it).first];
-    C_0[(*it).first] = orig*scalar;
+    to_ret.insert(to_ret.end(), make_pair((*it).first, (*it).second*scalar));
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+// The dense kernels below are kept as simple counted loops over contiguous 
+// arrays with no branches, so that the compiler vectorizes them.
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::scale(double* vals, double scalar, int n){
+  for(int i=0; i<n; ++i){
+    vals[i] = vals[i]*scalar;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::conc_grad(const double* c_ext, const double* c_int, 
+    double int_scale, double dr, double* grad, int n){
+  for(int i=0; i<n; ++i){
+    grad[i] = (c_ext[i] - c_int[i]*int_scale) / dr;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::flux(const double* D, const double* grad, const double* c, 
+    double v, double* q, int n){
+  for(int i=0; i<n; ++i){
+    q[i] = -D[i]*grad[i] + v*c[i];
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<int> MatTools::iso_union(const IsoConcMap& a, const IsoConcMap& b){
+  vector<int> to_ret;
+  to_ret.reserve(max(a.size(), b.size()));
+  IsoConcMap::const_iterator ait = a.begin();
+  IsoConcMap::const_iterator bit = b.begin();
+  while( ait != a.end() || bit != b.end() ){
+    if( bit == b.end() || (ait != a.end() && ait->first < bit->first) ){
+      to_ret.push_back((ait++)->first);
+    } else if( ait == a.end() || bit->first < ait->first ){
+      to_ret.push_back((bit++)->first);
+    } else {
+      to_ret.push_back(ait->first);
+      ++ait;
+      ++bit;
+    }
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::gather(const IsoConcMap& vals, const vector<int>& isos, 
+    double* out){
+  IsoConcMap::const_iterator it = vals.begin();
+  for(size_t i=0; i<isos.size(); ++i){
+    while( it != vals.end() && it->first < isos[i] ){
+      ++it;
+    }
+    out[i] = (it != vals.end() && it->first == isos[i]) ? it->second : 0;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::mask_or(const char* a, const char* b, char* out, int n){
+  for(int i=0; i<n; ++i){
+    out[i] = a[i] | b[i];
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MatTools::tridiag(const double* lower, const double* diag, 
+    const double* upper, double* x, double* work, int n_rows, int n_sys){
+  if( n_rows < 1 ){
+    return;
+  }
+  // forward sweep, work holds the modified upper coefficients
+  for(int j=0; j<n_sys; ++j){
+    work[j] = upper[j]/diag[j];
+    x[j] = x[j]/diag[j];
+  }
+  for(int i=1; i<n_rows; ++i){
+    const double* l = lower + i*n_sys;
+    const double* d = diag + i*n_sys;
+    const double* u = upper + i*n_sys;
+    const double* w_prev = work + (i-1)*n_sys;
+    const double* x_prev = x + (i-1)*n_sys;
+    double* w = work + i*n_sys;
+    double* xi = x + i*n_sys;
+    for(int j=0; j<n_sys; ++j){
+      double m = d[j] - l[j]*w_prev[j];
+      w[j] = u[j]/m;
+      xi[j] = (xi[j] - l[j]*x_prev[j])/m;
+    }
+  }
+  // back substitution
+  for(int i=n_rows-2; i>=0; --i){
+    const double* w = work + i*n_sys;
+    const double* x_next = x + (i+1)*n_sys;
+    double* xi = x + i*n_sys;
+    for(int j=0; j<n_sys; ++j){
+      xi[j] -= w[j]*x_next[j];
+    }
   }
-  return C_0;
 }
@@ -56,6 +56,13 @@ typedef double Flux;
   */
 typedef std::map<int, Flux> IsoFluxMap;
 
+/**
+   type definition for a map from isotopes to masses
+   The keys are the isotope identifiers Z*1000 + A
+   The values are the masses of each isotope [kg]
+  */
+typedef std::map<int, double> IsoMassMap;
+
 
 /** 
    @brief MatTools is a toolkit for manipulating materials. 
@@ -71,6 +78,18 @@ public:
     */
   static std::pair<IsoVector, double> sum_mats(std::deque<mat_rsrc_ptr> mats);
 
+  /**
+     adds the isotopic masses of a material to a running map of isotopic 
+     masses. A negative scale removes them, and any isotope that would be 
+     left with a negative mass is left with zero.
+
+     @param mat the material whose isotopes are added
+     @param masses the map of isotopic masses to add to [kg]
+     @param scale the factor applied to the material's masses, -1 to remove
+     @return the total mass added [kg]
+    */
+  static double add_masses(mat_rsrc_ptr mat, IsoMassMap& masses, double scale=1);
+
   /**
      removes the specified amount of the specified composition from a 
      deque of materials provided to the function by reference. 
@@ -83,6 +102,39 @@ public:
   static mat_rsrc_ptr extract(const CompMapPtr comp_to_rem, double kg_to_rem, 
       std::deque<mat_rsrc_ptr>& mat_list);
 
+  /**
+     removes the specified amount of the specified composition from a map 
+     of isotopic masses, in proportion to the composition, without merging 
+     any materials.
+
+     @param comp_to_rem a CompMapPtr representing what to remove
+     @param kg_to_rem a mass to remove of the CompMapPtr [kg]
+     @param masses the isotopic masses to remove that comp from [kg]
+     @return the material extracted
+     @throws CycRangeException if an isotope is short of the mass to remove
+    **/
+  static mat_rsrc_ptr extract(const CompMapPtr comp_to_rem, double kg_to_rem, 
+      IsoMassMap& masses);
+
+  /**
+     removes a mass of each of several isotopes from a map of isotopic 
+     masses, in one call. Nothing is removed if any isotope is short.
+
+     @param kgs_to_rem the mass of each isotope to remove [kg]
+     @param masses the isotopic masses to remove them from [kg]
+     @return a single material of everything extracted
+     @throws CycRangeException if an isotope is short of the mass to remove
+    **/
+  static mat_rsrc_ptr extract(const IsoMassMap& kgs_to_rem, IsoMassMap& masses);
+
+  /**
+     makes one material of a map of isotopic masses
+
+     @param masses the isotopic masses [kg]
+     @return a material with that composition and total mass
+    **/
+  static mat_rsrc_ptr mass_map_to_mat(const IsoMassMap& masses);
+
   /**
     Converts a CompMap and associated total mass to an IsoConcMap for a Volume
 
@@ -184,7 +236,91 @@ public:
     @param C_0 the original IsoConcMap, to be scaled.
     @param scalar the scalar by which to multiply each element of C_0 [-]
     */
-  static IsoConcMap scaleConcMap(IsoConcMap C_0, double scalar);
+  static IsoConcMap scaleConcMap(const IsoConcMap& C_0, double scalar);
+
+  /**
+    Scales n dense values in place by a scalar
+
+    @param vals the values to scale
+    @param scalar the scalar by which to multiply each value [-]
+    @param n the number of values
+    */
+  static void scale(double* vals, double scalar, int n);
+
+  /**
+    Computes n concentration gradients by a finite difference, 
+    grad[i] = (c_ext[i] - c_int[i]*int_scale)/dr
+
+    @param c_ext the external concentrations [kg/m^3]
+    @param c_int the internal concentrations [kg/m^3]
+    @param int_scale the factor applied to each internal concentration [-]
+    @param dr the distance between the two concentrations [m]
+    @param grad the gradients, filled by this function [kg/m^4]
+    @param n the number of values
+    */
+  static void conc_grad(const double* c_ext, const double* c_int, 
+      double int_scale, double dr, double* grad, int n);
+
+  /**
+    Computes n advective-dispersive fluxes, q[i] = -D[i]*grad[i] + v*c[i]
+
+    @param D the dispersion coefficients [m^2/s]
+    @param grad the concentration gradients [kg/m^4]
+    @param c the boundary concentrations [kg/m^3]
+    @param v the advective velocity [m/s]
+    @param q the fluxes, filled by this function [kg/m^2/s]
+    @param n the number of values
+    */
+  static void flux(const double* D, const double* grad, const double* c, 
+      double v, double* q, int n);
+
+  /**
+    Returns the isotopes of either of two maps, in increasing order
+
+    @param a the first map
+    @param b the second map
+    */
+  static std::vector<int> iso_union(const IsoConcMap& a, const IsoConcMap& b);
+
+  /**
+    Gathers the value of each of a list of isotopes from a map into a dense 
+    array, with zero for an isotope the map doesn't have. The isotopes and 
+    the map are both in order, so the map is walked once.
+
+    @param vals the map of values
+    @param isos the isotopes, in increasing order
+    @param out the values, filled by this function
+    */
+  static void gather(const IsoConcMap& vals, const std::vector<int>& isos, 
+      double* out);
+
+  /**
+    Combines n presence masks, out[i] = a[i] | b[i]
+
+    @param a the first mask
+    @param b the second mask
+    @param out the combined mask, filled by this function
+    @param n the number of values
+    */
+  static void mask_or(const char* a, const char* b, char* out, int n);
+
+  /**
+    Solves n_sys independent tridiagonal systems of n_rows rows at once, by 
+    the Thomas algorithm. Every array is row-major, n_rows x n_sys, so the 
+    value of row i of system j is at i*n_sys + j, and the inner loops run 
+    across the systems.
+
+    @param lower the coefficients left of the diagonal, row 0 is unused
+    @param diag the coefficients on the diagonal
+    @param upper the coefficients right of the diagonal, the last row is 
+    unused
+    @param x the right hand sides, replaced by the solutions
+    @param work scratch space, n_rows x n_sys
+    @param n_rows the number of rows in each system
+    @param n_sys the number of systems
+    */
+  static void tridiag(const double* lower, const double* diag, 
+      const double* upper, double* x, double* work, int n_rows, int n_sys);
   
 };
 #endif
@@ -21,15 +21,11 @@ using boost::lexical_cast;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MixedCellNuclide::MixedCellNuclide():
-  deg_rate_(0),
   tot_deg_(0),
-  last_degraded_(0),
-  v_(0),
-  porosity_(0),
-  sol_limited_(true),
-  kd_limited_(true)
+  last_degraded_(0)
 {
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
   vec_hist_ = VecHist();
@@ -39,15 +35,11 @@ MixedCellNuclide::MixedCellNuclide():
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MixedCellNuclide::MixedCellNuclide(QueryEngine* qe) : 
-  deg_rate_(0),
   tot_deg_(0),
-  last_degraded_(0),
-  v_(0),
-  porosity_(0),
-  sol_limited_(true),
-  kd_limited_(true)
+  last_degraded_(0)
 {
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
   vec_hist_ = VecHist();
@@ -56,6 +48,15 @@ MixedCellNuclide::MixedCellNuclide(QueryEngine* qe) :
   initModuleMembers(qe);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MixedCellNuclide::MixedCellNuclide(const MixedCellNuclide& src):
+  tot_deg_(0),
+  last_degraded_(0)
+{
+  last_updated_=0;
+  copy_from(src);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 MixedCellNuclide::~MixedCellNuclide(){
 }
@@ -73,25 +74,28 @@ void MixedCellNuclide::initModuleMembers(QueryEngine* qe){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 NuclideModelPtr MixedCellNuclide::copy(const NuclideModel& src){
   const MixedCellNuclide* src_ptr = dynamic_cast<const MixedCellNuclide*>(&src);
+  copy_from(*src_ptr);
 
-  set_v(src_ptr->v());
-  set_deg_rate(src_ptr->deg_rate());
-  set_kd_limited(src_ptr->kd_limited());
-  set_porosity(src_ptr->porosity());
-  set_sol_limited(src_ptr->sol_limited());
+  return shared_from_this();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MixedCellNuclide::copy_from(const MixedCellNuclide& src){
+  // the parameters are shared, not copied
+  params_ = src.params_;
   set_tot_deg(0);
   set_last_degraded(TI->time());
+  set_last_updated(TI->time());
 
-  // copy the geometry AND the centroid. It should be reset later.
-  set_geom(GeometryPtr(new Geometry()));
-  geom_->copy(src_ptr->geom(), src_ptr->geom()->centroid());
+  // the geometry is the template's until the component is placed, and the
+  // histories are made by the first update
+  set_geom(src.geom());
 
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  iso_masses_ = IsoMassMap();
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
-  update(TI->time());
-
-  return shared_from_this();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -114,7 +118,7 @@ void MixedCellNuclide::absorb(mat_rsrc_ptr matToAdd)
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRDRNuc") << "MixedCellNuclide is absorbing material: ";
   matToAdd->print();
-  wastes_.push_back(matToAdd);
+  absorb_mat(matToAdd);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -125,7 +129,7 @@ mat_rsrc_ptr MixedCellNuclide::extract(const CompMapPtr comp_to_rem, double kg_t
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRDRNuc") << "MixedCellNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
-  mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  mat_rsrc_ptr to_ret = extract_mat(comp_to_rem, kg_to_rem);
   update(TI->time());
   return to_ret;
 }
@@ -138,6 +142,11 @@ void MixedCellNuclide::transportNuclides(int the_time){
   update(the_time);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void MixedCellNuclide::degrade(int the_time){
+  update_degradation(the_time, deg_rate());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void MixedCellNuclide::set_deg_rate(double cur_rate){
   if( cur_rate < 0 || cur_rate > 1 ) {
@@ -149,7 +158,7 @@ void MixedCellNuclide::set_deg_rate(double cur_rate){
     LOG(LEV_ERROR,"GRDRNuc") << msg_ss.str();;
     throw CycRangeException(msg_ss.str());
   } else {
-    deg_rate_ = cur_rate;
+    params_.write().deg_rate = cur_rate;
   }
   assert((cur_rate >=0) && (cur_rate <= 1));
 }
@@ -165,7 +174,7 @@ void MixedCellNuclide::set_porosity(double porosity){
     LOG(LEV_ERROR,"GRDRNuc") << msg_ss.str();;
     throw CycRangeException(msg_ss.str());
   } else {
-    porosity_ = porosity;
+    params_.write().porosity = porosity;
   }
   assert((porosity >=0) && (porosity <= 1));
 }
@@ -194,48 +203,15 @@ IsoConcMap MixedCellNuclide::dirichlet_bc(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ConcGradMap MixedCellNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
-  ConcGradMap to_ret;
-
   IsoConcMap c_int = conc_hist(last_degraded());
   Radius r_int = geom_->radial_midpoint();
-  
-  int iso;
-  IsoConcMap::iterator it;
-  for( it=c_int.begin(); it != c_int.end(); ++it){
-    iso = (*it).first;
-    if( c_ext.count(iso) != 0) {  
-      // in both
-      to_ret[iso] = calc_conc_grad(c_ext[iso], c_int[iso]*tot_deg(), r_ext, r_int);
-    } else {  
-      // in c_int_only
-      to_ret[iso] = calc_conc_grad(0, c_int[iso]*tot_deg(), r_ext, r_int);
-    }
-  }
-  for( it=c_ext.begin(); it != c_ext.end(); ++it){
-    iso = (*it).first;
-    if( c_int.count(iso) == 0) { 
-      // in c_ext only
-      to_ret[iso] = calc_conc_grad(c_ext[iso], 0, r_ext, r_int);
-    }
-  }
-
-  return to_ret;
+  return calc_conc_grads(c_ext, c_int, tot_deg(), r_ext, r_int);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoFluxMap MixedCellNuclide::cauchy_bc(IsoConcMap c_ext, Radius r_ext){
   // -D dC/dx + v_xC = v_x C
-  IsoFluxMap to_ret;
-  ConcGradMap neumann = neumann_bc(c_ext, r_ext);
-  ConcGradMap::iterator it;
-  Iso iso;
-  Elem elem;
-  for( it = neumann.begin(); it != neumann.end(); ++it){
-    iso = (*it).first;
-    elem = iso/1000;
-    to_ret.insert(make_pair(iso, -mat_table_->D(elem)*(*it).second + v()*shared_from_this()->dirichlet_bc(iso)));
-  }
-  return to_ret;
+  return calc_fluxes(neumann_bcs(c_ext, r_ext), dirichlet_bcs(), v());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -248,41 +224,39 @@ IsoConcMap MixedCellNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr>
   // @TODO mats is unused in this (and analogous) functions.
   assert(last_degraded() <= the_time);
 
-  pair<IsoVector, double> sum_pair; 
-  sum_pair = vec_hist_[the_time];
+  // read the summed composition in place
+  const double* fracs = vec_hist_.row(the_time);
+  double mass = vec_hist_.mass(the_time);
+  const vector<Iso>& isos = vec_hist_.isos();
 
   IsoConcMap to_ret;
   int iso;
-  double mass;
   double m_ff;
   double m_aff;
-  double vol;
-  if(sum_pair.second != 0 && V_ff()!=0 && geom_->volume() != numeric_limits<double>::infinity()) { 
-    mass = sum_pair.second;
-    CompMapPtr curr_comp = sum_pair.first.comp();
-    CompMap::const_iterator it;
-    it=(*curr_comp).begin();
-    while(it != (*curr_comp).end() ) {
-      iso = (*it).first;
+  if(fracs != NULL && mass != 0 && V_ff()!=0 && geom_->volume() != numeric_limits<double>::infinity()) { 
+    for(size_t j=0; j < isos.size(); ++j){
+      if( VecHist::absent(fracs[j]) ){
+        continue;
+      }
+      iso = isos[j];
       if(kd_limited()){
-        m_ff = sorb(the_time, iso, (*it).second*mass);
+        m_ff = sorb(the_time, iso, fracs[j]*mass);
       } else { 
-        m_ff = (*it).second*mass;
+        m_ff = fracs[j]*mass;
       }
       if(sol_limited()){
         m_aff = precipitate(the_time, iso, m_ff);
       } else { 
         m_aff = m_ff;
       }
-      to_ret.insert(make_pair(iso, m_aff/V_ff()));
-      ++it;
+      to_ret.insert(to_ret.end(), make_pair(iso, m_aff/V_ff()));
     }
   } else {
     to_ret[ 92235 ] = 0; 
   }
-  conc_hist_[the_time] = to_ret ;
+  conc_hist_.set(the_time, to_ret);
 
-  return conc_hist_[the_time];
+  return to_ret;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -300,13 +274,13 @@ double MixedCellNuclide::update_degradation(int the_time, double cur_rate){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void MixedCellNuclide::update_vec_hist(int the_time){
-  vec_hist_[ the_time ] = MatTools::sum_mats(wastes_) ;
+  set_vec_hist(the_time);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-void MixedCellNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
+void MixedCellNuclide::update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters){
   std::map<NuclideModelPtr, std::pair<IsoVector,double> > to_ret;
-  std::vector<NuclideModelPtr>::iterator daughter;
+  std::vector<NuclideModelPtr>::const_iterator daughter;
   std::pair<IsoVector, double> source_term;
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
     source_term = (*daughter)->source_term_bc();
@@ -13,6 +13,8 @@
 #include <string>
 
 #include "NuclideModel.h"
+#include "PoolAlloc.h"
+#include "SharedParams.h"
 
 /// A shared pointer for the MixedCellNuclide object
 class MixedCellNuclide;
@@ -33,7 +35,7 @@ typedef boost::shared_ptr<MixedCellNuclide> MixedCellNuclidePtr;
    However, since the Far Field and the Envrionment do not degrade, these are 
    not well represented by the MixedCellNuclide model.
  */
-class MixedCellNuclide : public NuclideModel {
+class MixedCellNuclide : public NuclideModel, public PoolAlloc<MixedCellNuclide> {
   /*----------------------------*/
   /* All NuclideModel classes   */
   /* have the following members */
@@ -52,19 +54,38 @@ private:
    */
   MixedCellNuclide(QueryEngine* qe);
 
+  /**
+     Constructs a copy of a template model, sharing its parameters, without 
+     the default geometry made only to be replaced. Use create(src).
+
+     @param src the template model to copy
+   */
+  MixedCellNuclide(const MixedCellNuclide& src);
+
+  /// sets up this model as a copy of src, for copy() and create(src)
+  void copy_from(const MixedCellNuclide& src);
+
 public:
 
   /**
      A constructor for the Mixed Cell Nuclide Model that returns a shared pointer.
     */
-  static MixedCellNuclidePtr create (){ return MixedCellNuclidePtr(new MixedCellNuclide()); };
+  static MixedCellNuclidePtr create (){ return share(new MixedCellNuclide()); };
 
   /**
      A constructor for the Mixed Cell Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static MixedCellNuclidePtr create (QueryEngine* qe){ return MixedCellNuclidePtr(new MixedCellNuclide(qe)); };
+  static MixedCellNuclidePtr create (QueryEngine* qe){ return share(new MixedCellNuclide(qe)); };
+
+  /**
+     A constructor for the MixedCell Nuclide Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static MixedCellNuclidePtr create(const MixedCellNuclide& src){ return share(new MixedCellNuclide(src)); };
 
   /**
      Virtual destructor deletes datamembers that are object pointers.
@@ -116,6 +137,13 @@ public:
    */
   virtual void transportNuclides(int time);
 
+  /**
+     Degrades the component at the degradation rate, to the time
+
+     @param time the timestep to degrade to
+   */
+  virtual void degrade(int time);
+
   /**
      Returns the nuclide model type
    */
@@ -171,9 +199,9 @@ public:
   /** 
      returns the degradation rate that characterizes this model
    *
-     @return deg_rate_ fraction per year
+     @return the degradation rate, a fraction per year
    */
-  const double deg_rate() const {return deg_rate_;};
+  const double deg_rate() const {return params_->deg_rate;};
 
   /** 
      returns the degradation rate that characterizes this model
@@ -241,7 +269,7 @@ public:
      @param daughter nuclide_model of an internal component. there may be many.
      
     */
-  void update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters); 
+  void update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters); 
 
   /**
      Update the isotopic vector history to incorporate sorption
@@ -269,7 +297,7 @@ public:
   const double tot_deg() const {return tot_deg_;};
 
   /// sets the total degradation of the component
-  void set_tot_deg(double tot_deg){tot_deg_=tot_deg;};
+  void set_tot_deg(double tot_deg){tot_deg_=tot_deg; invalidate_bcs();};
 
   /**
     Set the porosity (a fraction) of the material of this component. [%] 
@@ -279,17 +307,17 @@ public:
   /**
     The porosity (a fraction) of the material of this component. [%] 
    */
-  const double porosity() const {return porosity_;};
+  const double porosity() const {return params_->porosity;};
 
   /**
-    Set the advective velocity v_ through this component. [m/s] 
+    Set the advective velocity through this component. [m/s] 
    */
-  void set_v(double v){v_ = v;};
+  void set_v(double v){params_.write().v = v; invalidate_bcs();};
 
   /**
     The advective velocity through this component. [m/s] 
    */
-  const double v() const {return v_;};
+  const double v() const {return params_->v;};
 
   /**
     Set the last_degraded_ time [integer timestamp]
@@ -302,16 +330,16 @@ public:
   const int last_degraded() const {return last_degraded_;};
 
   /// Sets boolean indicating whether to incorporate solubility limits
-  void set_sol_limited(bool sol_limited){sol_limited_=sol_limited;}; 
+  void set_sol_limited(bool sol_limited){params_.write().sol_limited=sol_limited;}; 
 
   /// Gets boolean indicating whether to incorporate solubility limits
-  const bool sol_limited() const {return sol_limited_;};
+  const bool sol_limited() const {return params_->sol_limited;};
 
   /// Sets boolean indicating whether to incorporate sorption
-  void set_kd_limited(bool kd_limited){kd_limited_=kd_limited;}; 
+  void set_kd_limited(bool kd_limited){params_.write().kd_limited=kd_limited;}; 
 
   /// Gets boolean indicating whether to incorporate sorption
-  const bool kd_limited() const {return kd_limited_;};
+  const bool kd_limited() const {return params_->kd_limited;};
 
   /// Gets the total volume
   double V_T();
@@ -326,15 +354,30 @@ public:
   double V_ff();
 
 protected:
-  /**
-    The advective velocity through this component [m/s]
-   */
-  double v_;
+  /// the parameters of a MixedCellNuclide, which its copies share
+  struct Params {
+    /// Constructor, for the default parameters
+    Params() : v(0), deg_rate(0), porosity(0), sol_limited(true), 
+      kd_limited(true) {};
 
-  /**
-    The degradation rate that defines this model, fraction per year.
-   */
-  double deg_rate_;
+    /// The advective velocity through this component [m/s]
+    double v;
+
+    /// The degradation rate that defines this model, fraction per year.
+    double deg_rate;
+
+    /// The porosity of the material in the component, a fraction [%] 
+    double porosity;
+
+    /// Boolean indicates whether to incorporate solubility limits. (True = yes )
+    bool sol_limited;
+
+    /// Boolean indicates whether to incorporate sorption. (True = yes )
+    bool kd_limited;
+  };
+
+  /// the parameters, shared with the template until one is set
+  SharedParams<Params> params_;
 
   /// the total fraction that this component has degraded
   double tot_deg_;
@@ -342,14 +385,5 @@ protected:
   /// the last timestamp at which this component was last degraded [integer timestamp]
   int last_degraded_;
 
-  /// The porosity of the material in the component, a fraction [%] 
-  double porosity_;
-
-  /// Boolean indicates whether to incorporate solubility limits. (True = yes )
-  bool sol_limited_;
-
-  /// Boolean indicates whether to incorporate sorption. (True = yes )
-  bool kd_limited_;
-
 };
 #endif
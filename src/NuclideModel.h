@@ -11,6 +11,9 @@
 #include "Geometry.h"
 #include "MatTools.h"
 #include "MatDataTable.h"
+#include "IsoHist.h"
+#include "DecayOperator.h"
+#include "Timer.h"
 
 /**
    enumerated list of types of nuclide transport model
@@ -20,23 +23,24 @@ enum NuclideModelType {
   LUMPED_NUCLIDE, 
   MIXEDCELL_NUCLIDE, 
   ONEDIMPPM_NUCLIDE, 
+  RADIALFV_NUCLIDE, 
   STUB_NUCLIDE, 
   LAST_NUCLIDE};
 
 /** 
-   type definition for a map from times to IsoConcMap
-   The keys are timesteps, in the unit of the timesteps in the simulation.
-   The values are the IsoConcMap maps at those timesteps
+   type definition for the history of concentrations over time
+   The rows are timesteps, in the unit of the timesteps in the simulation.
+   The columns are the concentrations of each isotope at those timesteps
   */
-typedef std::map<int, IsoConcMap> ConcHist;
+typedef IsoHist ConcHist;
 
 
 /**
-   type definition for a map from times to (normalized) IsoVectors, 
-   paired with masses
+   type definition for the history of (normalized) IsoVectors over time, 
+   each row paired with a mass
 
   */
-typedef std::map<int, std::pair<IsoVector, double> > VecHist;
+typedef IsoHist VecHist;
 
 /// A shared pointer for the abstract NuclideModel class
 class NuclideModel;
@@ -103,7 +107,8 @@ public:
      @param daughter nuclide_model of an internal component. there may be many.
      
      */
-  virtual void update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters)=0; 
+  virtual void update_inner_bc(int the_time, 
+      const std::vector<NuclideModelPtr>& daughters)=0; 
 
   /**
      Transports nuclides from the inner boundary to the outer boundary in this 
@@ -113,6 +118,15 @@ public:
    */
   virtual void transportNuclides(int time) = 0 ;
 
+  /**
+     Degrades the component to the_time, without transporting anything. The 
+     coupled EBSSolver calls this in place of transportNuclides. Models that 
+     don't degrade do nothing.
+
+     @param the_time the timestep to degrade to
+   */
+  virtual void degrade(int the_time) {};
+
   /** 
      returns the NuclideModelType of the model
    */
@@ -139,16 +153,14 @@ public:
   virtual std::pair<IsoVector, double> source_term_bc()=0;
 
   /**
-     returns the prescribed concentration at the boundary, the source term bc
-     in kg
+     returns the mass of one isotope in the source term bc, in kg
     
      @param tope the isotope to query
-     @return C the concentration at the boundary in kg/m^3
+     @return the mass of the isotope available at the boundary in kg
    */
   double source_term_bc(Iso tope) { 
-    IsoVector st=this->source_term_bc().first;
-    double massfrac = st.massFraction(tope);
-    return( (massfrac == 0) ? massfrac*this->source_term_bc().second : 0);
+    std::pair<IsoVector, double> st = this->source_term_bc();
+    return st.first.massFraction(tope)*st.second;
   };
 
   /**
@@ -168,8 +180,24 @@ public:
      @return C the concentration at the boundary in kg/m^3
    */
   Concentration dirichlet_bc(Iso tope) { 
-    IsoConcMap::iterator found = this->dirichlet_bc().find(tope);
-    return(found != this->dirichlet_bc().end() ? (*found).second : 0);
+    return find_bc(dirichlet_bcs(), tope);
+  };
+
+  /**
+     returns the dirichlet bc of every isotope, evaluated once and cached 
+     until the component is next updated
+    
+     @return C the concentrations at the boundary in kg/m^3
+   */
+  const IsoConcMap& dirichlet_bcs() {
+    refresh_bcs();
+    if( !dirichlet_valid_ ){
+      IsoConcMap dirichlet = this->dirichlet_bc();
+      refresh_bcs();
+      dirichlet_.swap(dirichlet);
+      dirichlet_valid_ = true;
+    }
+    return dirichlet_;
   };
   
   /**
@@ -191,8 +219,28 @@ public:
      @return dCdx the concentration gradient at the boundary in kg/m^3
    */
   ConcGrad neumann_bc( IsoConcMap c_ext, Radius r_ext, Iso tope) {
-    IsoConcMap::iterator found = this->neumann_bc(c_ext, r_ext).find(tope);
-    return((found != this->neumann_bc(c_ext, r_ext).end()) ? (*found).second : 0);
+    return find_bc(neumann_bcs(c_ext, r_ext), tope);
+  };
+
+  /**
+     returns the neumann bc of every isotope, evaluated once and cached 
+     until the component is next updated or the external conditions change
+    
+     @param c_ext the external concentration in the parent component
+     @param r_ext the radius in the parent component corresponding to c_ext
+     @return dCdx the concentration gradients at the boundary in kg/m^3
+   */
+  const ConcGradMap& neumann_bcs(const IsoConcMap& c_ext, Radius r_ext) {
+    refresh_bcs();
+    if( !neumann_valid_ || r_ext != neumann_r_ext_ || c_ext != neumann_c_ext_ ){
+      ConcGradMap neumann = this->neumann_bc(c_ext, r_ext);
+      refresh_bcs();
+      neumann_.swap(neumann);
+      neumann_c_ext_ = c_ext;
+      neumann_r_ext_ = r_ext;
+      neumann_valid_ = true;
+    }
+    return neumann_;
   };
 
   /**
@@ -201,14 +249,54 @@ public:
      @return qC the solute flux at the boundary in kg/m^2/s
    */
   virtual IsoFluxMap cauchy_bc(IsoConcMap c_ext, Radius r_ext) = 0;
+
+  /**
+     returns the flux of one isotope at the boundary, the cauchy bc
+    
+     @param c_ext the external concentration in the parent component
+     @param r_ext the radius in the parent component corresponding to c_ext
+     @param tope the isotope to query
+     @return qC the solute flux at the boundary in kg/m^2/s
+   */
   Flux cauchy_bc(IsoConcMap c_ext, Radius r_ext, Iso tope) {
-    IsoConcMap::iterator found = this->cauchy_bc(c_ext,r_ext).find(tope);
-    return(found != this->cauchy_bc(c_ext, r_ext).end() ? (*found).second : 0);
+    return find_bc(cauchy_bcs(c_ext, r_ext), tope);
   };
+
+  /**
+     returns the cauchy bc of every isotope, evaluated once and cached 
+     until the component is next updated or the external conditions change
     
+     @param c_ext the external concentration in the parent component
+     @param r_ext the radius in the parent component corresponding to c_ext
+     @return qC the solute fluxes at the boundary in kg/m^2/s
+   */
+  const IsoFluxMap& cauchy_bcs(const IsoConcMap& c_ext, Radius r_ext) {
+    refresh_bcs();
+    if( !cauchy_valid_ || r_ext != cauchy_r_ext_ || c_ext != cauchy_c_ext_ ){
+      IsoFluxMap cauchy = this->cauchy_bc(c_ext, r_ext);
+      refresh_bcs();
+      cauchy_.swap(cauchy);
+      cauchy_c_ext_ = c_ext;
+      cauchy_r_ext_ = r_ext;
+      cauchy_valid_ = true;
+    }
+    return cauchy_;
+  };
+
+  /**
+     discards the cached boundary conditions. Models call this when a 
+     parameter the boundary conditions depend on changes. Updates to the 
+     concentration history discard them automatically.
+   */
+  void invalidate_bcs() {
+    dirichlet_valid_ = false;
+    neumann_valid_ = false;
+    cauchy_valid_ = false;
+  };
+
 
   /// Allows the geometry object to be set
-  void set_geom(GeometryPtr geom){ geom_=geom; };
+  void set_geom(GeometryPtr geom){ geom_=geom; invalidate_bcs(); };
 
   /// Returns the geom_ data member
   const GeometryPtr geom() const {return geom_;};
@@ -219,7 +307,12 @@ public:
      @param time the time to query the contained contaminant mass
      @return contained_mass_ throughout the component volume, in kg, at time
    */
-  double contained_mass(int the_time){return this->vec_hist(the_time).second;}
+  double contained_mass(int the_time){
+    if( last_updated() < the_time ){
+      update(the_time);
+    }
+    return vec_hist_.mass(the_time);
+  }
 
   /**
      Returns the IsoVector mass pair for a certain time
@@ -232,11 +325,9 @@ public:
       update(the_time);
     }
     std::pair<IsoVector, double> to_ret;
-    VecHist::const_iterator it;
     if( !vec_hist_.empty() ) {
-      it = vec_hist_.find(the_time);
-      if( it != vec_hist_.end() ){
-        to_ret = (*it).second;
+      if( vec_hist_.has(the_time) ){
+        to_ret = vec_hist_.vec(the_time);
         assert(to_ret.second < 1000 );
       } 
     } else { 
@@ -247,6 +338,9 @@ public:
     return to_ret;
   }
 
+  /// Returns the whole isotopic history, for reading rows in place
+  const VecHist& vec_hist() const {return vec_hist_;};
+
   /** 
      The IsoVector representing the summed, normalized material in 
      the component.
@@ -272,10 +366,8 @@ public:
       update(the_time);
     }
     IsoConcMap to_ret;
-    ConcHist::iterator it;
-    it = conc_hist_.find(the_time);
-    if( it != conc_hist_.end() ){
-      to_ret = (*it).second;
+    if( conc_hist_.has(the_time) ){
+      to_ret = conc_hist_.map(the_time);
     } else {
       to_ret[92235] = 0 ; // zero
     }
@@ -290,18 +382,15 @@ public:
      @return conc_hist(time)[iso].second, or zero if not found
     */
   Concentration conc_hist(int the_time, Iso tope){
-    Concentration to_ret;
-    IsoConcMap conc_map = conc_hist(the_time);
-    IsoConcMap::iterator it;
-    it = conc_map.find(tope);
-    if(it != conc_map.end()){
-      to_ret = (*it).second;
-    }else{
-      to_ret = 0;
+    if( last_updated() < the_time ){
+      update(the_time);
     }
-    return to_ret;
+    return conc_hist_.at(the_time, tope);
   }
 
+  /// Returns the whole concentration history, for reading rows in place
+  const ConcHist& conc_hist() const {return conc_hist_;};
+
   /**
      Returns the concentration gradient based on a simple finite difference 
      between two datapoints.
@@ -331,10 +420,160 @@ public:
     return to_ret;
   }
 
-  void set_mat_table(MatDataTablePtr mat_table){mat_table_ = MatDataTablePtr(mat_table);}
+  /**
+     Returns the concentration gradients for every isotope in either 
+     concentration map, each by the same finite difference as calc_conc_grad. 
+     Isotopes missing from one map are taken to be zero there.
+
+     @param c_ext external concentrations, at r_ext
+     @param c_int internal concentrations, at r_int
+     @param int_scale a factor applied to each internal concentration
+     @param r_ext external radial midpoint
+     @param r_int interal radil midpoint
+    */
+  ConcGradMap calc_conc_grads(const IsoConcMap& c_ext, const IsoConcMap& c_int,
+      double int_scale, Radius r_ext, Radius r_int){
+    // validate the radii once, as calc_conc_grad would for each isotope
+    calc_conc_grad(0, 0, r_ext, r_int);
+
+    // line both maps up on the isotopes of either, in local arrays
+    std::vector<int> isos = MatTools::iso_union(c_ext, c_int);
+    int n = isos.size();
+    ConcGradMap to_ret;
+    if( n == 0 ){
+      return to_ret;
+    }
+    std::vector<double> ext(n), in(n), grad(n);
+    MatTools::gather(c_ext, isos, &ext[0]);
+    MatTools::gather(c_int, isos, &in[0]);
+    MatTools::conc_grad(&ext[0], &in[0], int_scale, r_ext - r_int, &grad[0], n);
+    for(int i=0; i < n; ++i){
+      to_ret.insert(to_ret.end(), std::make_pair(isos[i], grad[i]));
+    }
+    return to_ret;
+  }
+
+  /**
+     Returns the advective-dispersive flux, -D dC/dx + v C, for every 
+     isotope with a concentration gradient. The dispersion coefficient is 
+     that of the isotope's element in the mat_table_.
+
+     @param grads the concentration gradients at the boundary
+     @param c_bc the concentrations at the boundary
+     @param v the advective velocity
+    */
+  IsoFluxMap calc_fluxes(const ConcGradMap& grads, const IsoConcMap& c_bc, 
+      double v){
+    // only the isotopes with a gradient have a flux
+    std::vector<int> isos = MatTools::iso_union(grads, ConcGradMap());
+    int n = isos.size();
+    IsoFluxMap to_ret;
+    if( n == 0 ){
+      return to_ret;
+    }
+    std::vector<double> grad(n), conc(n), D(n), q(n);
+    MatTools::gather(grads, isos, &grad[0]);
+    MatTools::gather(c_bc, isos, &conc[0]);
+    for(int i=0; i < n; ++i){
+      D[i] = mat_table_->D(isos[i]/1000);
+    }
+    MatTools::flux(&D[0], &grad[0], &conc[0], v, &q[0], n);
+    for(int i=0; i < n; ++i){
+      to_ret.insert(to_ret.end(), std::make_pair(isos[i], q[i]));
+    }
+    return to_ret;
+  }
+
+  void set_mat_table(MatDataTablePtr mat_table){
+    mat_table_ = MatDataTablePtr(mat_table);
+    invalidate_bcs();
+  }
 
-  /// Returns wastes_
-  std::deque<mat_rsrc_ptr> wastes() {return wastes_;};
+  /// Returns the material data table of this model
+  const MatDataTablePtr mat_table() const {return mat_table_;};
+
+  /**
+     Returns the contained wastes, merged into one material. The material is 
+     only made when it is asked for, after the contents change.
+   */
+  const std::deque<mat_rsrc_ptr>& wastes() {
+    if( !wastes_current_ ){
+      wastes_.clear();
+      IsoMassMap::const_iterator it;
+      for(it = iso_masses_.begin(); it != iso_masses_.end(); ++it){
+        if( (*it).second > 0 ){
+          wastes_.push_back(MatTools::mass_map_to_mat(iso_masses_));
+          break;
+        }
+      }
+      wastes_current_ = true;
+    }
+    return wastes_;
+  };
+
+  /**
+     Extracts the given mass of each of several isotopes from this 
+     NuclideModel in one call.
+
+     @param kgs_to_rem the mass of each isotope to remove [kg]
+     @return a single material of everything extracted
+   */
+  mat_rsrc_ptr extract_isos(const IsoMassMap& kgs_to_rem) {
+    return extract_isos(kgs_to_rem, TI->time());
+  };
+
+  /**
+     Extracts the given mass of each of several isotopes from this 
+     NuclideModel in one call, and updates it at the_time.
+
+     @param kgs_to_rem the mass of each isotope to remove [kg]
+     @param the_time the time at which to update the hists
+     @return a single material of everything extracted
+   */
+  mat_rsrc_ptr extract_isos(const IsoMassMap& kgs_to_rem, int the_time) {
+    mat_rsrc_ptr to_ret = MatTools::extract(kgs_to_rem, iso_masses_);
+    wastes_current_ = false;
+    update(the_time);
+    return to_ret;
+  };
+
+  /// Returns the running mass of each contained isotope, in kg
+  const IsoMassMap& iso_masses() const {return iso_masses_;};
+
+  /// Returns the total running mass of the contained isotopes, in kg
+  double total_iso_mass() const {
+    double kg = 0;
+    IsoMassMap::const_iterator it;
+    for(it = iso_masses_.begin(); it != iso_masses_.end(); ++it){
+      kg += it->second;
+    }
+    return kg;
+  };
+
+  /**
+     Replaces the running mass of each contained isotope, as when the 
+     contents have decayed. The histories are brought up to date by the 
+     next transport or update.
+
+     @param masses the new mass of each isotope [kg]
+   */
+  virtual void set_iso_masses(const IsoMassMap& masses) {
+    iso_masses_ = masses;
+    wastes_current_ = false;
+  };
+
+  /**
+     Decays the running mass of each contained isotope over a step, in 
+     place. The histories are brought up to date by the next transport or 
+     update.
+
+     @param decay the decay data
+     @param dt the length of the step [timesteps]
+   */
+  virtual void decay(DecayOperator& decay, int dt) {
+    decay.apply(iso_masses_, dt);
+    wastes_current_ = false;
+  };
 
   /// returns the time at which the vec_hist and conc_hist were updated
   int last_updated(){return last_updated_;};
@@ -356,14 +595,106 @@ public:
   };
 
 protected:
-  /// A vector of the wastes contained by this component
-  ///wastes(){return component_->wastes();};
+  /**
+     Default constructor, with no boundary conditions cached
+   */
+  NuclideModel() : 
+    wastes_current_(true),
+    neumann_r_ext_(0),
+    cauchy_r_ext_(0),
+    dirichlet_valid_(false),
+    neumann_valid_(false),
+    cauchy_valid_(false),
+    bcs_version_(0),
+    bcs_updated_(0),
+    bcs_time_(0)
+  {};
+
+  /// the value of an isotope in a boundary condition map, or zero if absent
+  static double find_bc(const std::map<Iso, double>& bcs, Iso tope) {
+    std::map<Iso, double>::const_iterator found = bcs.find(tope);
+    return (found != bcs.end()) ? (*found).second : 0;
+  };
+
+  /** 
+     discards the cached boundary conditions if the concentration history, 
+     the update time, or the simulation time has changed since they were 
+     evaluated
+   */
+  void refresh_bcs() {
+    if( bcs_version_ != conc_hist_.version() || 
+        bcs_updated_ != last_updated_ || 
+        bcs_time_ != TI->time() ){
+      invalidate_bcs();
+      bcs_version_ = conc_hist_.version();
+      bcs_updated_ = last_updated_;
+      bcs_time_ = TI->time();
+    }
+  };
+
+  /**
+     records the running isotopic masses as the vec_hist_ row at the_time, 
+     normalized, with their total mass. This costs one pass over the 
+     isotopes, however many materials have been absorbed.
+
+     @param the_time the time at which to record the vec_hist_
+   */
+  void set_vec_hist(int the_time){
+    double kg = 0;
+    IsoMassMap::const_iterator it;
+    for(it = iso_masses_.begin(); it != iso_masses_.end(); ++it){
+      kg += (*it).second;
+    }
+    IsoConcMap fracs;
+    if( kg > 0 ){
+      for(it = iso_masses_.begin(); it != iso_masses_.end(); ++it){
+        fracs.insert(fracs.end(), std::make_pair((*it).first, (*it).second/kg));
+      }
+    } else {
+      fracs[92235] = 0;
+    }
+    vec_hist_.set(the_time, fracs, kg);
+  };
+
+  /**
+     adds a material to the contained wastes
+
+     @param mat the material to absorb
+   */
+  void absorb_mat(mat_rsrc_ptr mat){
+    MatTools::add_masses(mat, iso_masses_);
+    wastes_current_ = false;
+  };
+
+  /**
+     takes a composition from the contained wastes, in proportion to the 
+     composition, without merging the wastes
+
+     @param comp_to_rem the composition to remove
+     @param kg_to_rem the mass to remove [kg]
+     @return the material extracted
+   */
+  mat_rsrc_ptr extract_mat(const CompMapPtr comp_to_rem, double kg_to_rem){
+    mat_rsrc_ptr to_ret = MatTools::extract(comp_to_rem, kg_to_rem, iso_masses_);
+    wastes_current_ = false;
+    return to_ret;
+  };
+
+  /// The wastes contained by this component, made from iso_masses_ by 
+  /// wastes() when they are asked for
   std::deque<mat_rsrc_ptr> wastes_;
 
-  /// The map of times to isotopes to concentrations, in kg/m^3
+  /// false if iso_masses_ has changed since wastes_ was made
+  bool wastes_current_;
+
+  /// The running mass of each contained isotope, in kg, kept by absorb 
+  /// and extract
+  IsoMassMap iso_masses_;
+
+  /// The history of isotopic concentrations, in kg/m^3
   ConcHist conc_hist_;
   
-  /// The map of times to IsoVectors
+  /// The history of IsoVectors and masses
   VecHist vec_hist_;
   
   /// A shared pointer to the geometry of the component
@@ -375,5 +706,28 @@ protected:
   /// the time at which the histories were last updated
   int last_updated_;
 
+  /// the cached dirichlet bc
+  IsoConcMap dirichlet_;
+
+  /// the cached neumann bc, and the external conditions it was evaluated for
+  ConcGradMap neumann_;
+  IsoConcMap neumann_c_ext_;
+  Radius neumann_r_ext_;
+
+  /// the cached cauchy bc, and the external conditions it was evaluated for
+  IsoFluxMap cauchy_;
+  IsoConcMap cauchy_c_ext_;
+  Radius cauchy_r_ext_;
+
+  /// whether each cached bc is current
+  bool dirichlet_valid_;
+  bool neumann_valid_;
+  bool cauchy_valid_;
+
+  /// the conc_hist_ version, update time and simulation time of the cache
+  unsigned long bcs_version_;
+  int bcs_updated_;
+  int bcs_time_;
+
 };
 #endif
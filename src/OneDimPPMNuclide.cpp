@@ -5,9 +5,11 @@
 #include <iostream>
 #include <fstream>
 #include <deque>
+#include <algorithm>
 #include <time.h>
 #include <boost/lexical_cast.hpp>
-#include <boost/math/special_functions/erf.hpp>
+#include <math.h>
+#include <boost/math/constants/constants.hpp>
 
 #include "CycException.h"
 #include "Logger.h"
@@ -18,30 +20,22 @@ using namespace std;
 using boost::lexical_cast;
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-OneDimPPMNuclide::OneDimPPMNuclide():
-  Ci_(0),
-  Co_(0),
-  v_(0),
-  porosity_(0),
-  rho_(0)
+OneDimPPMNuclide::OneDimPPMNuclide()
 {
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
 
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-OneDimPPMNuclide::OneDimPPMNuclide(QueryEngine* qe):
-  Ci_(0),
-  Co_(0),
-  v_(0),
-  porosity_(0),
-  rho_(0)
+OneDimPPMNuclide::OneDimPPMNuclide(QueryEngine* qe)
 {
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   set_geom(GeometryPtr(new Geometry()));
   last_updated_=0;
   vec_hist_ = VecHist();
@@ -49,20 +43,28 @@ OneDimPPMNuclide::OneDimPPMNuclide(QueryEngine* qe):
   initModuleMembers(qe);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+OneDimPPMNuclide::OneDimPPMNuclide(const OneDimPPMNuclide& src)
+{
+  last_updated_=0;
+  copy_from(src);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 OneDimPPMNuclide::~OneDimPPMNuclide(){ }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void OneDimPPMNuclide::initModuleMembers(QueryEngine* qe){
+  Params& params = params_.write();
   // C(x,0)=C_i
-  Ci_ = lexical_cast<double>(qe->getElementContent("initial_concentration"));
+  params.Ci = lexical_cast<double>(qe->getElementContent("initial_concentration"));
   // -D{\frac{\partial C}{\partial x}}|_{x=0} + vC = vC_0, for t<t_0
-  Co_ = lexical_cast<double>(qe->getElementContent("source_concentration"));
+  params.Co = lexical_cast<double>(qe->getElementContent("source_concentration"));
   // advective velocity (hopefully the same as the whole system).
-  v_ = lexical_cast<double>(qe->getElementContent("advective_velocity"));
+  params.v = lexical_cast<double>(qe->getElementContent("advective_velocity"));
   // rock parameters
-  porosity_ = lexical_cast<double>(qe->getElementContent("porosity"));
-  rho_ = lexical_cast<double>(qe->getElementContent("bulk_density"));
+  params.porosity = lexical_cast<double>(qe->getElementContent("porosity"));
+  params.rho = lexical_cast<double>(qe->getElementContent("bulk_density"));
 
   LOG(LEV_DEBUG2,"GR1DNuc") << "The OneDimPPMNuclide Class init(cur) function has been called";;
 }
@@ -70,24 +72,26 @@ void OneDimPPMNuclide::initModuleMembers(QueryEngine* qe){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 NuclideModelPtr OneDimPPMNuclide::copy(const NuclideModel& src){
   const OneDimPPMNuclide* src_ptr = dynamic_cast<const OneDimPPMNuclide*>(&src);
+  copy_from(*src_ptr);
 
-  set_last_updated(TI->time());
-  set_porosity(src_ptr->porosity());
-  set_rho(src_ptr->rho());
-  set_v(src_ptr->v());
-  set_Ci(src_ptr->Ci());
-  set_Co(src_ptr->Co());
+  return shared_from_this();
+}
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void OneDimPPMNuclide::copy_from(const OneDimPPMNuclide& src){
+  set_last_updated(TI->time());
+  // the parameters are shared, not copied
+  params_ = src.params_;
 
-  // copy the geometry AND the centroid. It should be reset later.
-  set_geom(geom_->copy(src_ptr->geom(), src_ptr->geom()->centroid()));
+  // the geometry is the template's until the component is placed, and the
+  // histories are made by the first update
+  set_geom(src.geom());
 
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  iso_masses_ = IsoMassMap();
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
-  update_vec_hist(TI->time());
-
-  return shared_from_this();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -103,7 +107,7 @@ void OneDimPPMNuclide::absorb(mat_rsrc_ptr matToAdd)
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GR1DNuc") << "OneDimPPMNuclide is absorbing material: ";
   matToAdd->print();
-  wastes_.push_back(matToAdd);
+  absorb_mat(matToAdd);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -114,7 +118,7 @@ mat_rsrc_ptr OneDimPPMNuclide::extract(const CompMapPtr comp_to_rem, double kg_t
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GR1DNuc") << "OneDimPPMNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
-  mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  mat_rsrc_ptr to_ret = extract_mat(comp_to_rem, kg_to_rem);
   update(TI->time());
   return to_ret;
 }
@@ -159,52 +163,20 @@ IsoConcMap OneDimPPMNuclide::dirichlet_bc(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ConcGradMap OneDimPPMNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
-  ConcGradMap to_ret;
   IsoConcMap c_int = conc_hist(last_updated());
   Radius r_int = geom()->radial_midpoint();
-
-  int iso;
-  IsoConcMap::iterator it;
-  for( it=c_int.begin(); it!=c_int.end(); ++it ){
-    iso=(*it).first;
-    if(c_ext.count(iso) != 0 ){
-      // in both
-      to_ret[iso] = calc_conc_grad(c_ext[iso], c_int[iso], r_ext, r_int);
-    } else { 
-      // in c_int only
-      to_ret[iso] = calc_conc_grad(0, c_int[iso], r_ext, r_int);
-    }
-  }
-  for( it=c_ext.begin(); it!=c_ext.end(); ++it){
-    iso = (*it).first;
-    if( c_int.count(iso) == 0 ){
-      // in c_ext only
-      to_ret[iso] = calc_conc_grad(c_ext[iso], 0, r_ext, r_int);
-    }
-  }
-  return to_ret;
+  return calc_conc_grads(c_ext, c_int, 1, r_ext, r_int);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoFluxMap OneDimPPMNuclide::cauchy_bc(IsoConcMap c_ext, Radius r_ext){
-  IsoFluxMap to_ret;
-  ConcGradMap neumann = neumann_bc(c_ext,r_ext);
-
-  ConcGradMap::iterator it;
-  Iso iso;
-  Elem elem;
-  for( it=neumann.begin(); it!=neumann.end(); ++it){
-    iso=(*it).first;
-    elem=iso/1000;
-    to_ret.insert(make_pair(iso, -mat_table_->D(elem)*(*it).second + shared_from_this()->dirichlet_bc(iso)*v()));
-  }
-
-  return to_ret;
+  // -D dC/dx + v_xC = v_x C
+  return calc_fluxes(neumann_bcs(c_ext, r_ext), dirichlet_bcs(), v());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void OneDimPPMNuclide::update_vec_hist(int the_time){
-  vec_hist_[the_time]=MatTools::sum_mats(wastes_);
+  set_vec_hist(the_time);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -216,46 +188,133 @@ void OneDimPPMNuclide::update_conc_hist(int the_time, deque<mat_rsrc_ptr> mats){
   assert(last_updated() <= the_time);
   IsoConcMap to_ret;
 
-  pair<IsoVector, double> sum_pair;
-  IsoConcMap C_0 = MatTools::comp_to_conc_map(sum_pair.first.comp(), sum_pair.second, V_f());
+  // the initial concentration is the contained mass, as summed into the 
+  // vec_hist_ by update_vec_hist, read in place
+  IsoConcMap C_0;
+  const double* fracs = vec_hist_.row(the_time);
+  double mass = vec_hist_.mass(the_time);
+  const vector<Iso>& isos = vec_hist_.isos();
+  if( fracs != NULL && mass != 0 ){
+    double scale = mass/V_f();
+    for(size_t j=0; j < isos.size(); ++j){
+      if( !VecHist::absent(fracs[j]) ){
+        C_0.insert(C_0.end(), make_pair(isos[j], fracs[j]*scale));
+      }
+    }
+  }
 
   /// @TODO this is a placeholder and only calculates C at the midpoint
-  /// @TODO this doesn't actually use the mats... 
   Radius r_calc = geom_->radial_midpoint();
   to_ret = conc_profile(C_0, r_calc, the_time);
   set_last_updated(the_time);
-  conc_hist_[the_time] = to_ret;
+  conc_hist_.set(the_time, to_ret);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-IsoConcMap OneDimPPMNuclide::conc_profile(IsoConcMap C_0, Radius r, int dt){
+IsoConcMap OneDimPPMNuclide::conc_profile(const IsoConcMap& C_0, Radius r, 
+    int dt){
+  // decay is applied to the contents by the repository, before transport
+  return conc_profile(C_0, vector<Radius>(1, r), dt).front();
+}
 
-  // @TODO decay will accidentally get neglected here if you don't watch out. Fix.
-  IsoConcMap to_ret;
-  IsoConcMap::iterator it;
-  Iso iso;
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<IsoConcMap> OneDimPPMNuclide::conc_profile(const IsoConcMap& C_0, 
+    const vector<Radius>& radii, int dt){
+  vector<Iso> isos;
+  vector<double> c_0;
+  isos.reserve(C_0.size());
+  c_0.reserve(C_0.size());
+  IsoConcMap::const_iterator it;
   for(it=C_0.begin(); it!=C_0.end(); ++it){
-    iso = (*it).first;
-    to_ret[iso] = calculate_conc(C_0, r, iso, dt);
+    isos.push_back((*it).first);
+    c_0.push_back((*it).second);
+  }
+
+  vector<double> concs;
+  calc_concs(c_0, isos, radii, dt, concs);
+
+  vector<IsoConcMap> to_ret(radii.size());
+  int n = isos.size();
+  for(size_t k=0; k < radii.size(); ++k){
+    for(int i=0; i < n; ++i){
+      to_ret[k].insert(to_ret[k].end(), make_pair(isos[i], concs[k*n+i]));
+    }
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+vector<Radius> OneDimPPMNuclide::profile_radii(int n_cells){
+  Radius r_in = geom_->inner_radius();
+  Radius dr = (geom_->outer_radius() - r_in)/n_cells;
+  vector<Radius> to_ret;
+  to_ret.reserve(n_cells);
+  for(int k=0; k < n_cells; ++k){
+    to_ret.push_back(r_in + (k + 0.5)*dr);
   }
   return to_ret;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-double OneDimPPMNuclide::calculate_conc(IsoConcMap C_0, double r, Iso iso, int dt) {
-  double D_L = mat_table_->D(iso/1000);
+double OneDimPPMNuclide::calculate_conc(const IsoConcMap& C_0, double r, 
+    Iso iso, int dt) {
+  IsoConcMap::const_iterator found = C_0.find(iso);
+  vector<double> c_0(1, found == C_0.end() ? 0 : (*found).second);
+  vector<double> concs;
+  calc_concs(c_0, vector<Iso>(1, iso), vector<Radius>(1, r), dt, concs);
+  return concs.front();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void OneDimPPMNuclide::calc_concs(const vector<double>& c_0, 
+    const vector<Iso>& isos, const vector<Radius>& radii, int dt, 
+    vector<double>& concs) {
+  int n = isos.size();
+  concs.resize(n*radii.size());
+  if( dt <= 0 ){
+    // no time has passed
+    for(size_t k=0; k < radii.size(); ++k){
+      std::copy(c_0.begin(), c_0.end(), concs.begin() + k*n);
+    }
+    return;
+  }
+
+  // the terms that only depend on the element, computed once per element.
+  // the isotopes are sorted, so those of an element are adjacent.
   double pi = boost::math::constants::pi<double>();
-  double term_1_frac = (r-v_*dt)/2*pow(D_L*dt,0.5);
-  double term_1_scalar = boost::math::erfc(term_1_frac);
-  double term_2_radical = (pow(v_,2)*dt/pi/D_L);
-  double term_2_exp = exp( -pow(r-v_*dt,2)/(4*D_L*dt)); 
-  double term_2_scalar = 0.5*pow(term_2_radical,0.5)*term_2_exp;
-  double term_3_factor = 0.5*(1 + v_*r/D_L + pow(v_,2)*dt/D_L);
-  double term_3_exp = exp(v_*r/D_L);
-  double term_3_erfc = boost::math::erfc( (r - v_*dt) / (2*pow(D_L*dt,0.5)) );
-  double term_3_scalar = 0.5*term_3_factor*term_3_exp*term_3_erfc;
-  double scalar = term_1_scalar + term_2_scalar + term_3_scalar;
-  return C_0[iso]*0.5*scalar;
+  double v = params_->v;
+  vector<double> inv_2_sqrt_Dt(n), inv_4_Dt(n), v_D(n), term_2_coeff(n), 
+    term_3_coeff(n), half_c_0(n);
+  Elem prev_elem = -1;
+  double D_L = 0;
+  for(int i=0; i < n; ++i){
+    Elem elem = isos[i]/1000;
+    if( elem != prev_elem ){
+      D_L = mat_table_->D(elem);
+      prev_elem = elem;
+    }
+    double sqrt_Dt = sqrt(D_L*dt);
+    inv_2_sqrt_Dt[i] = 1/(2*sqrt_Dt);
+    inv_4_Dt[i] = 1/(4*D_L*dt);
+    v_D[i] = v/D_L;
+    term_2_coeff[i] = 0.5*sqrt(v*v*dt/pi/D_L);
+    term_3_coeff[i] = 0.25*(1 + v*v*dt/D_L);
+    half_c_0[i] = 0.5*c_0[i];
+  }
+
+  // one erfc and two exps per point, the erfc shared by the first and 
+  // third terms
+  double* out = concs.empty() ? NULL : &concs[0];
+  for(size_t k=0; k < radii.size(); ++k, out += n){
+    double r = radii[k];
+    double u = r - v*dt;
+    for(int i=0; i < n; ++i){
+      double term_erfc = erfc(u*inv_2_sqrt_Dt[i]);
+      double term_2 = term_2_coeff[i]*exp(-u*u*inv_4_Dt[i]);
+      double term_3 = (term_3_coeff[i] + 0.25*v_D[i]*r)*exp(v_D[i]*r)*term_erfc;
+      out[i] = half_c_0[i]*(term_erfc + term_2 + term_3);
+    }
+  }
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -271,7 +330,7 @@ void OneDimPPMNuclide::set_porosity(double porosity){
     LOG(LEV_ERROR, "GRDRNuc") << msg_ss.str();;
     throw CycRangeException(msg_ss.str());
   }
-  porosity_ = porosity;
+  params_.write().porosity = porosity;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -287,22 +346,23 @@ void OneDimPPMNuclide::set_rho(double rho){
     LOG(LEV_ERROR, "GRDRNuc") << msg_ss.str();;
     throw CycRangeException(msg_ss.str());
   }
-  rho_ = rho;
+  params_.write().rho = rho;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void OneDimPPMNuclide::set_Co(double Co){
-  Co_=Co;
+  params_.write().Co = Co;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void OneDimPPMNuclide::set_Ci(double Ci){
-  Ci_=Ci;
+  params_.write().Ci = Ci;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void OneDimPPMNuclide::set_v(double v){
-  v_=v;
+  params_.write().v = v;
+  invalidate_bcs();
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -315,10 +375,10 @@ double OneDimPPMNuclide::V_f(){
   return MatTools::V_f(V_T(), porosity());
 }
 
-void OneDimPPMNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
+void OneDimPPMNuclide::update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters){
   /// @TODO use cauchy.
   std::map<NuclideModelPtr, std::pair<IsoVector,double> > to_ret;
-  std::vector<NuclideModelPtr>::iterator daughter;
+  std::vector<NuclideModelPtr>::const_iterator daughter;
   std::pair<IsoVector, double> source_term;
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
     source_term = (*daughter)->source_term_bc();
@@ -13,6 +13,8 @@
 #include <string>
 
 #include "NuclideModel.h"
+#include "PoolAlloc.h"
+#include "SharedParams.h"
 
 /// A shared pointer for the OneDimPPMNuclide object
 class OneDimPPMNuclide;
@@ -71,7 +73,7 @@ typedef boost::shared_ptr<OneDimPPMNuclide> OneDimPPMNuclidePtr;
    Buffer or the Environment components, due to its long running time and lack 
    of degradation.
    */
-class OneDimPPMNuclide : public NuclideModel {
+class OneDimPPMNuclide : public NuclideModel, public PoolAlloc<OneDimPPMNuclide> {
 private:
   
   /**
@@ -88,19 +90,38 @@ private:
    */
   OneDimPPMNuclide(QueryEngine* qe);
 
+  /**
+     Constructs a copy of a template model, sharing its parameters, without 
+     the default geometry made only to be replaced. Use create(src).
+
+     @param src the template model to copy
+   */
+  OneDimPPMNuclide(const OneDimPPMNuclide& src);
+
+  /// sets up this model as a copy of src, for copy() and create(src)
+  void copy_from(const OneDimPPMNuclide& src);
+
 public:
 
   /**
      A constructor for the OneDimPPM Nuclide Model that returns a shared pointer.
     */
-  static OneDimPPMNuclidePtr create (){ return OneDimPPMNuclidePtr(new OneDimPPMNuclide()); };
+  static OneDimPPMNuclidePtr create (){ return share(new OneDimPPMNuclide()); };
 
   /**
      A constructor for the OneDimPPM Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static OneDimPPMNuclidePtr create (QueryEngine* qe){ return OneDimPPMNuclidePtr(new OneDimPPMNuclide(qe)); };
+  static OneDimPPMNuclidePtr create (QueryEngine* qe){ return share(new OneDimPPMNuclide(qe)); };
+
+  /**
+     A constructor for the OneDimPPM Nuclide Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static OneDimPPMNuclidePtr create(const OneDimPPMNuclide& src){ return share(new OneDimPPMNuclide(src)); };
 
   /**
      Virtual destructor deletes datamembers that are object pointers.
@@ -159,7 +180,7 @@ public:
      @param time the timestep at which the nuclides should be transported
      @param daughter nuclide_model of an internal component. there may be many.
      */
-  void update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters); 
+  void update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters); 
 
   /**
      Returns the nuclide model type
@@ -218,7 +239,7 @@ public:
   /**
      return porosity
     */
-  const double porosity() const {return porosity_;};
+  const double porosity() const {return params_->porosity;};
 
   /** 
      Updates the available concentration using the wastes_ as mats
@@ -242,8 +263,28 @@ public:
      @param r_calc the radius at which to calculate the IsoConcMap [m]
      @param dt the change in time since C_0 was calculated [timestep]
     */
-  IsoConcMap conc_profile(IsoConcMap C_0, double r_calc, int dt);
+  IsoConcMap conc_profile(const IsoConcMap& C_0, double r_calc, int dt);
+
+  /**
+     Calculates the concentration of each isotope a certain time, at each of 
+     many radii, in one pass.
+     
+     @param C_0 the initial concentration
+     @param radii the radii at which to calculate the concentrations [m]
+     @param dt the change in time since C_0 was calculated [timestep]
+     @return the concentrations, one IsoConcMap per radius
+    */
+  std::vector<IsoConcMap> conc_profile(const IsoConcMap& C_0, 
+      const std::vector<Radius>& radii, int dt);
 
+  /**
+     The midpoints of n_cells shells of equal thickness between the inner 
+     and outer radius, for a radial concentration profile.
+
+     @param n_cells the number of shells
+     @return the radius of the middle of each shell, innermost first [m]
+    */
+  std::vector<Radius> profile_radii(int n_cells);
 
   /**
      Calculates the concentration of a single isotope due to C_0 after dt at 
@@ -257,45 +298,45 @@ public:
      @param iso the isotope whose concentration is being queried [-]
      @param dt the change in time since C_0 was calculated [timestep]
     */
-  double calculate_conc(IsoConcMap C_0, double r_calc, int iso, int dt);
+  double calculate_conc(const IsoConcMap& C_0, double r_calc, int iso, int dt);
 
 
-  /// sets the porosity_ variable, the percent void of the medium 
+  /// sets the porosity variable, the percent void of the medium 
   void set_porosity(double porosity);
 
   /**
      return initial concentration
      @TODO this shoudn't be a double it should be an isoconcmap
     */
-  const double Ci() const {return Ci_;};
+  const double Ci() const {return params_->Ci;};
 
-  /// sets the Ci_ variable, the initial concentration.
+  /// sets the Ci variable, the initial concentration.
   void set_Ci(double Ci);
 
   /**
      return Co, the source concentration?
      @TODO figure out what you intended to do with this variable. It shouldn't be a double, should be IsoConcMap.
     */
-  const double Co() const {return Co_;};
+  const double Co() const {return params_->Co;};
 
-  /// sets the Co_ variable, the source concentration 
+  /// sets the Co variable, the source concentration 
   void set_Co(double Co);
 
   /**
      return bulk density
     */
-  const double rho() const {return rho_;};
+  const double rho() const {return params_->rho;};
 
-  /// sets the rho_ variable, the dry bulk density of the medium [kg/m^3] 
+  /// sets the rho variable, the dry bulk density of the medium [kg/m^3] 
   void set_rho(double rho);
 
   /**
     The advective velocity through this component. [m/s] 
     @TODO is m/s the right unit? shouldn't be m/yr?
    */
-  const double v() const {return v_;};
+  const double v() const {return params_->v;};
 
-  /// sets the v_ variable, the advective velocity through this component. 
+  /// sets the v variable, the advective velocity through this component. 
   void set_v(double v);
 
   /// Gets the total fluid volume
@@ -306,23 +347,49 @@ public:
 
 protected:
   /**
-    The advective velocity through the waste packages in units of m/s.
-  */
-  double v_;
+     The analytic solution for many isotopes at many radii. The terms that 
+     depend only on the element, D_L and the square root of D_L*dt, are 
+     computed once per element, and the terms that depend on the radius 
+     once per point, in straight loops over the isotopes. 
+
+     @param c_0 the initial concentration of each isotope [kg/m^3]
+     @param isos the isotopes, in the order of c_0
+     @param radii the radii at which to calculate the concentrations [m]
+     @param dt the change in time since c_0 was calculated [timestep]
+     @param concs the concentrations, one row of isotopes per radius 
+     [kg/m^3]
+    */
+  void calc_concs(const std::vector<double>& c_0, 
+      const std::vector<Iso>& isos, const std::vector<Radius>& radii, 
+      int dt, std::vector<double>& concs);
+
+  /// the parameters of a OneDimPPMNuclide, which its copies share
+  struct Params {
+    /// Constructor, for the default parameters
+    Params() : v(0), Ci(0), Co(0), porosity(0), rho(0) {};
+
+    /**
+      The advective velocity through the waste packages in units of m/s.
+    */
+    double v;
+
+    /// The initial contaminant concentration, C(x,0), in g/cm^3
+    // @TODO make this an isovector, maybe with a recipe
+    double Ci;
 
-  /// The initial contaminant concentration, C(x,0), in g/cm^3
-  // @TODO make this an isovector, maybe with a recipe
-  double Ci_;
+    /// The contaminant concentration constantly at the source until t_0, in g/cm^3
+    // @TODO make this an isovector, maybe with a recipe
+    double Co;
 
-  /// The contaminant concentration constantly at the source until t_0, in g/cm^3
-  // @TODO make this an isovector, maybe with a recipe
-  double Co_;
+    /// Porosity of the component matrix, a fraction between 0 and 1, inclusive.
+    double porosity;
 
-  /// Porosity of the component matrix, a fraction between 0 and 1, inclusive.
-  double porosity_;
+    /// The bulk (dry) density of the component matrix, in g/cm^3.
+    double rho;
+  };
 
-  /// The bulk (dry) density of the component matrix, in g/cm^3.
-  double rho_;
+  /// the parameters, shared with the template until one is set
+  SharedParams<Params> params_;
 
 };
 
@@ -0,0 +1,91 @@
+/*! \file PoolAlloc.h
+  \brief Declares the PoolAlloc class template used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_POOLALLOC_H)
+#define _POOLALLOC_H
+
+#include <new>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+#include <boost/checked_delete.hpp>
+#include <boost/pool/pool_alloc.hpp>
+#include <boost/pool/singleton_pool.hpp>
+
+/**
+   @brief PoolAlloc gives a class its own pool of memory, so that the many
+   small objects created as waste is emplaced aren't each allocated from the
+   heap.
+
+   A class T that derives from PoolAlloc<T> is allocated by new from a
+   boost::singleton_pool of blocks of sizeof(T), and returned to it by
+   delete. A class derived from T, of another size, falls back to the
+   global operator new. share() also takes the reference count of a
+   shared_ptr from a pool, so that creating a shared object costs no heap
+   allocation once the pools have grown.
+
+   The pools are locked, so objects may be created and destroyed on any
+   thread. The memory of a pool is kept for reuse, rather than returned to
+   the system, until the end of the simulation.
+ */
+template <class T>
+class PoolAlloc {
+public:
+  /**
+     allocates an object of T from the pool
+
+     @param size the size of the object being created
+     @throws std::bad_alloc if the pool can't grow
+   */
+  static void* operator new(std::size_t size){
+    if( size != sizeof(T) ){
+      return ::operator new(size);
+    }
+    // T is complete by the time this is instantiated, unlike in the class
+    typedef boost::singleton_pool<PoolAlloc<T>, sizeof(T)> Pool;
+    void* to_ret = Pool::malloc();
+    if( !to_ret ){
+      throw std::bad_alloc();
+    }
+    return to_ret;
+  };
+
+  /**
+     returns an object of T to the pool
+
+     @param ptr the object being destroyed
+     @param size the size of the object being destroyed
+   */
+  static void operator delete(void* ptr, std::size_t size){
+    if( !ptr ){
+      return;
+    }
+    if( size != sizeof(T) ){
+      ::operator delete(ptr);
+      return;
+    }
+    typedef boost::singleton_pool<PoolAlloc<T>, sizeof(T)> Pool;
+    Pool::free(ptr);
+  };
+
+  /**
+     wraps a new object in a shared_ptr whose reference count is allocated
+     from a pool too
+
+     @param ptr the object, just created by new
+   */
+  template <class U>
+  static boost::shared_ptr<U> share(U* ptr){
+    return boost::shared_ptr<U>(ptr, boost::checked_deleter<U>(),
+        boost::fast_pool_allocator<U>());
+  };
+
+protected:
+  /// only the classes that derive from PoolAlloc are created
+  PoolAlloc(){};
+
+  /// and they are not destroyed through a PoolAlloc pointer
+  ~PoolAlloc(){};
+};
+
+#endif
@@ -0,0 +1,507 @@
+/*! \file RadialFVNuclide.cpp
+    \brief Implements the RadialFVNuclide class used by the Generic Repository 
+    \author Kathryn D. Huff
+ */
+#include <iostream>
+#include <fstream>
+#include <deque>
+#include <algorithm>
+#include <limits>
+#include <time.h>
+#include <assert.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/math/constants/constants.hpp>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "Timer.h"
+#include "RadialFVNuclide.h"
+#include "Material.h"
+
+using namespace std;
+using boost::lexical_cast;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RadialFVNuclide::RadialFVNuclide()
+{
+  wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  set_geom(GeometryPtr(new Geometry()));
+  last_updated_=0;
+  vec_hist_ = VecHist();
+  conc_hist_ = ConcHist();
+  update(0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RadialFVNuclide::RadialFVNuclide(QueryEngine* qe)
+{
+  wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  set_geom(GeometryPtr(new Geometry()));
+  last_updated_=0;
+  vec_hist_ = VecHist();
+  conc_hist_ = ConcHist();
+  update(0);
+  initModuleMembers(qe);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RadialFVNuclide::RadialFVNuclide(const RadialFVNuclide& src)
+{
+  last_updated_=0;
+  copy_from(src);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RadialFVNuclide::~RadialFVNuclide(){
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RadialFVNuclide::initModuleMembers(QueryEngine* qe){
+  set_v(lexical_cast<double>(qe->getElementContent("advective_velocity")));
+  set_porosity(lexical_cast<double>(qe->getElementContent("porosity")));
+  set_rho(lexical_cast<double>(qe->getElementContent("bulk_density")));
+  set_n_cells(lexical_cast<int>(qe->getElementContent("cells")));
+  LOG(LEV_DEBUG2,"GRRFNuc") << "The RadialFVNuclide Class initModuleMembers(qe) function has been called";;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+NuclideModelPtr RadialFVNuclide::copy(const NuclideModel& src){
+  const RadialFVNuclide* src_ptr = dynamic_cast<const RadialFVNuclide*>(&src);
+  copy_from(*src_ptr);
+
+  return shared_from_this();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RadialFVNuclide::copy_from(const RadialFVNuclide& src){
+  // the parameters are shared, not copied
+  params_ = src.params_;
+  invalidate_bcs();
+  set_last_updated(TI->time());
+
+  // the geometry is the template's until the component is placed, and the
+  // histories are made by the first update
+  set_geom(src.geom());
+
+  wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
+  iso_masses_ = IsoMassMap();
+  isos_.clear();
+  cell_masses_.clear();
+  vec_hist_ = VecHist();
+  conc_hist_ = ConcHist();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::update(int the_time) {
+  sync_cells();
+  update_vec_hist(the_time);
+  update_conc_hist(the_time);
+  set_last_updated(the_time);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::print(){
+    LOG(LEV_DEBUG2,"GRRFNuc") << "RadialFVNuclide Model";;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::absorb(mat_rsrc_ptr matToAdd)
+{
+  // the new mass is put in the innermost cell by sync_cells
+  LOG(LEV_DEBUG2,"GRRFNuc") << "RadialFVNuclide is absorbing material: ";
+  matToAdd->print();
+  absorb_mat(matToAdd);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+mat_rsrc_ptr RadialFVNuclide::extract(const CompMapPtr comp_to_rem, double kg_to_rem)
+{
+  // the mass is taken from the outermost cells by sync_cells
+  LOG(LEV_DEBUG2,"GRRFNuc") << "RadialFVNuclide" << "is extracting composition: ";
+  comp_to_rem->print() ;
+  mat_rsrc_ptr to_ret = extract_mat(comp_to_rem, kg_to_rem);
+  update(TI->time());
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::transportNuclides(int the_time){
+  assert(last_updated() <= the_time);
+  sync_cells();
+  step(the_time - last_updated());
+  update(the_time);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters){
+  std::vector<NuclideModelPtr>::const_iterator daughter;
+  std::pair<IsoVector, double> source_term;
+  for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
+    source_term = (*daughter)->source_term_bc();
+    if( source_term.second > 0 ){
+      absorb((*daughter)->extract(source_term.first.comp(), source_term.second));
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+pair<IsoVector, double> RadialFVNuclide::source_term_bc(){
+  if( last_updated() < TI->time() ){
+    update(TI->time());
+  }
+  IsoMassMap outer = cell_masses(n_cells() - 1);
+  CompMapPtr comp_map = CompMapPtr(new CompMap(MASS));
+  double tot_mass = 0;
+  IsoMassMap::iterator it;
+  for( it=outer.begin(); it!=outer.end(); ++it){
+    if( (*it).second > 0 ){
+      (*comp_map)[(*it).first] = (*it).second;
+      tot_mass += (*it).second;
+    }
+  }
+  if( tot_mass <= 0 ){
+    return make_pair(contained_vec(last_updated()), 0.0);
+  }
+  return make_pair(IsoVector(comp_map), tot_mass);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoConcMap RadialFVNuclide::dirichlet_bc(){
+  return conc_hist(last_updated());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+ConcGradMap RadialFVNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
+  IsoConcMap c_int = conc_hist(last_updated());
+  Radius r_int = cell_midpoint(n_cells() - 1);
+  return calc_conc_grads(c_ext, c_int, 1, r_ext, r_int);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoFluxMap RadialFVNuclide::cauchy_bc(IsoConcMap c_ext, Radius r_ext){
+  // -D dC/dx + v_xC = v_x C
+  return calc_fluxes(neumann_bcs(c_ext, r_ext), dirichlet_bcs(), v());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoConcMap RadialFVNuclide::update_conc_hist(int the_time){
+  IsoConcMap to_ret = cell_conc(n_cells() - 1);
+  if( to_ret.empty() ){
+    to_ret[ 92235 ] = 0; 
+  }
+  conc_hist_.set(the_time, to_ret);
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::update_vec_hist(int the_time){
+  set_vec_hist(the_time);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoConcMap RadialFVNuclide::cell_conc(int cell){
+  validate_cell(cell);
+  IsoConcMap to_ret;
+  double V_fluid = porosity()*cell_volume(cell);
+  int n = isos_.size();
+  for(int j=0; j < n; ++j){
+    double conc = 0;
+    if( V_fluid > 0 ){
+      conc = cell_masses_[cell*n + j]/(V_fluid*retardation(isos_[j]));
+    }
+    to_ret.insert(to_ret.end(), make_pair(isos_[j], conc));
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+IsoMassMap RadialFVNuclide::cell_masses(int cell){
+  validate_cell(cell);
+  IsoMassMap to_ret;
+  int n = isos_.size();
+  for(int j=0; j < n; ++j){
+    to_ret.insert(to_ret.end(), make_pair(isos_[j], cell_masses_[cell*n + j]));
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+Radius RadialFVNuclide::cell_midpoint(int cell){
+  Radius r_in = geom_->inner_radius();
+  Radius dr = (geom_->outer_radius() - r_in)/n_cells();
+  return r_in + (cell + 0.5)*dr;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double RadialFVNuclide::cell_volume(int cell){
+  double pi = boost::math::constants::pi<double>();
+  Radius r_in = geom_->inner_radius();
+  Radius dr = (geom_->outer_radius() - r_in)/n_cells();
+  Radius r_lo = r_in + cell*dr;
+  Radius r_hi = r_in + (cell + 1)*dr;
+  return pi*(r_hi*r_hi - r_lo*r_lo)*geom_->length();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double RadialFVNuclide::retardation(Iso tope){
+  if( porosity() == 0 ){
+    return 1;
+  }
+  return 1 + rho()*mat_table_->K_d(tope/1000)/porosity();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::validate_cell(int cell){
+  if( cell < 0 || cell >= n_cells() ) {
+    stringstream msg_ss;
+    msg_ss << "The RadialFVNuclide has cells 0 to " << n_cells() - 1;
+    msg_ss << ". The cell requested was ";
+    msg_ss << cell;
+    msg_ss <<  ".";
+    LOG(LEV_ERROR,"GRRFNuc") << msg_ss.str();;
+    throw CycRangeException(msg_ss.str());
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::remap_cells(){
+  // the columns are every isotope there is or has been in the cells
+  vector<Iso> isos;
+  isos.reserve(isos_.size() + iso_masses_.size());
+  vector<Iso>::iterator old_it = isos_.begin();
+  IsoMassMap::const_iterator it = iso_masses_.begin();
+  while( old_it != isos_.end() || it != iso_masses_.end() ){
+    if( it == iso_masses_.end() || 
+        (old_it != isos_.end() && *old_it < (*it).first) ){
+      isos.push_back(*old_it++);
+    } else {
+      if( old_it != isos_.end() && *old_it == (*it).first ){
+        ++old_it;
+      }
+      isos.push_back((*it++).first);
+    }
+  }
+
+  int n = isos.size();
+  if( isos != isos_ ){
+    vector<double> masses(n_cells()*n, 0);
+    int k = 0;
+    for(size_t j=0; j < isos_.size(); ++j){
+      while( isos[k] != isos_[j] ){
+        ++k;
+      }
+      for(int i=0; i < n_cells(); ++i){
+        masses[i*n + k] = cell_masses_[i*isos_.size() + j];
+      }
+    }
+    isos_.swap(isos);
+    cell_masses_.swap(masses);
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::sync_cells(){
+  remap_cells();
+  int n = isos_.size();
+
+  // added mass goes in at the inner boundary, and removed mass comes out 
+  // at the outer boundary
+  for(int j=0; j < n; ++j){
+    IsoMassMap::const_iterator found = iso_masses_.find(isos_[j]);
+    double target = (found == iso_masses_.end()) ? 0 : (*found).second;
+    double total = 0;
+    for(int i=0; i < n_cells(); ++i){
+      total += cell_masses_[i*n + j];
+    }
+    double diff = target - total;
+    if( diff > 0 ){
+      cell_masses_[j] += diff;
+    } else {
+      for(int i=n_cells()-1; i >= 0 && diff < 0; --i){
+        double taken = min(cell_masses_[i*n + j], -diff);
+        cell_masses_[i*n + j] -= taken;
+        diff += taken;
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::decay(DecayOperator& decay, int dt){
+  IsoMassMap masses(iso_masses_);
+  decay.apply(masses, dt);
+  set_iso_masses(masses);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::set_iso_masses(const IsoMassMap& masses){
+  sync_cells();
+  vector<double> cell_tot(n_cells(), 0);
+  double tot = 0;
+  int n_old = isos_.size();
+  for(int i=0; i < n_cells(); ++i){
+    for(int j=0; j < n_old; ++j){
+      cell_tot[i] += cell_masses_[i*n_old + j];
+    }
+    tot += cell_tot[i];
+  }
+
+  iso_masses_ = masses;
+  wastes_current_ = false;
+  remap_cells();
+
+  // the new mass of an isotope is spread like the old mass of it, or like 
+  // all of the old mass if it is newly made
+  int n = isos_.size();
+  for(int j=0; j < n; ++j){
+    IsoMassMap::const_iterator found = iso_masses_.find(isos_[j]);
+    double target = (found == iso_masses_.end()) ? 0 : (*found).second;
+    double total = 0;
+    for(int i=0; i < n_cells(); ++i){
+      total += cell_masses_[i*n + j];
+    }
+    for(int i=0; i < n_cells(); ++i){
+      double& cell = cell_masses_[i*n + j];
+      if( total > 0 ){
+        cell *= target/total;
+      } else if( tot > 0 ){
+        cell = target*cell_tot[i]/tot;
+      } else {
+        cell = (i == 0) ? target : 0;
+      }
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::step(int dt){
+  int n = isos_.size();
+  int N = n_cells();
+  Radius r_in = geom_->inner_radius();
+  Radius r_out = geom_->outer_radius();
+  if( dt <= 0 || n == 0 || N < 2 || porosity() == 0 || r_out <= r_in ){
+    // there is nothing to move, or nowhere to move it
+    return;
+  }
+  if( r_out == numeric_limits<double>::infinity() ){
+    stringstream msg_ss;
+    msg_ss << "The RadialFVNuclide can't divide an infinite component into cells.";
+    LOG(LEV_ERROR,"GRRFNuc") << msg_ss.str();;
+    throw CycRangeException(msg_ss.str());
+  }
+
+  // the dispersion and retardation of each isotope, once per element
+  vector<double> D(n), R(n);
+  Elem prev_elem = -1;
+  for(int j=0; j < n; ++j){
+    Elem elem = isos_[j]/1000;
+    if( elem != prev_elem ){
+      D[j] = mat_table_->D(elem);
+      R[j] = retardation(isos_[j]);
+      prev_elem = elem;
+    } else {
+      D[j] = D[j-1];
+      R[j] = R[j-1];
+    }
+  }
+
+  // the storage term of each cell, and the cell concentrations to solve for
+  vector<double> lower(N*n, 0), diag(N*n), upper(N*n, 0), x(N*n), work(N*n);
+  vector<double> fluid(N);
+  for(int i=0; i < N; ++i){
+    fluid[i] = porosity()*cell_volume(i);
+    for(int j=0; j < n; ++j){
+      diag[i*n + j] = fluid[i]*R[j]/dt;
+      x[i*n + j] = cell_masses_[i*n + j]/dt;
+    }
+  }
+
+  // the dispersive and upwinded advective exchange across each inner face
+  double pi = boost::math::constants::pi<double>();
+  double dr = (r_out - r_in)/N;
+  for(int f=1; f < N; ++f){
+    double area = 2*pi*(r_in + f*dr)*geom_->length()*porosity();
+    double a_plus = max(area*v(), 0.0);
+    double a_minus = min(area*v(), 0.0);
+    double* d_lo = &diag[(f-1)*n];
+    double* u_lo = &upper[(f-1)*n];
+    double* l_hi = &lower[f*n];
+    double* d_hi = &diag[f*n];
+    for(int j=0; j < n; ++j){
+      double g = area*D[j]/dr;
+      d_lo[j] += g + a_plus;
+      u_lo[j] += a_minus - g;
+      l_hi[j] -= g + a_plus;
+      d_hi[j] += g - a_minus;
+    }
+  }
+
+  MatTools::tridiag(&lower[0], &diag[0], &upper[0], &x[0], &work[0], N, n);
+
+  // back to the mass in each cell, sorbed and dissolved
+  for(int i=0; i < N; ++i){
+    for(int j=0; j < n; ++j){
+      cell_masses_[i*n + j] = max(0.0, x[i*n + j]*fluid[i]*R[j]);
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::set_n_cells(int n_cells){
+  if( n_cells < 1 ) {
+    stringstream msg_ss;
+    msg_ss << "The RadialFVNuclide needs at least one cell.";
+    msg_ss << " The value provided was ";
+    msg_ss << n_cells;
+    msg_ss <<  ".";
+    LOG(LEV_ERROR,"GRRFNuc") << msg_ss.str();;
+    throw CycRangeException(msg_ss.str());
+  }
+  params_.write().n_cells = n_cells;
+  cell_masses_.assign(n_cells*isos_.size(), 0);
+  sync_cells();
+  invalidate_bcs();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::set_porosity(double porosity){
+  if( porosity < 0 || porosity > 1 ) {
+    stringstream msg_ss;
+    msg_ss << "The RadialFVNuclide porosity range is 0 to 1, inclusive.";
+    msg_ss << " The value provided was ";
+    msg_ss << porosity;
+    msg_ss <<  ".";
+    LOG(LEV_ERROR,"GRRFNuc") << msg_ss.str();;
+    throw CycRangeException(msg_ss.str());
+  }
+  params_.write().porosity = porosity;
+  invalidate_bcs();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclide::set_rho(double rho){
+  if( rho < 0 ) {
+    stringstream msg_ss;
+    msg_ss << "The RadialFVNuclide bulk density must not be negative.";
+    msg_ss << " The value provided was ";
+    msg_ss << rho;
+    msg_ss <<  ".";
+    LOG(LEV_ERROR,"GRRFNuc") << msg_ss.str();;
+    throw CycRangeException(msg_ss.str());
+  }
+  params_.write().rho = rho;
+  invalidate_bcs();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double RadialFVNuclide::V_f(){
+  return MatTools::V_f(V_T(),porosity());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double RadialFVNuclide::V_T(){
+  return geom_->volume();
+}
@@ -0,0 +1,385 @@
+/*! \file RadialFVNuclide.h
+  \brief Declares the RadialFVNuclide class used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_RADIALFVNUCLIDE_H)
+#define _RADIALFVNUCLIDE_H
+
+#include <iostream>
+#include "Logger.h"
+#include <deque>
+#include <vector>
+#include <map>
+#include <string>
+
+#include "NuclideModel.h"
+#include "PoolAlloc.h"
+#include "SharedParams.h"
+
+/// A shared pointer for the RadialFVNuclide object
+class RadialFVNuclide;
+typedef boost::shared_ptr<RadialFVNuclide> RadialFVNuclidePtr;
+
+/**
+   @brief RadialFVNuclide is a nuclide model that resolves the contaminant
+   concentration across the thickness of the component.
+
+   The annulus between the inner and outer radius of the component is
+   divided into cells of equal thickness. In each timestep, the
+   advection-dispersion-sorption equation
+   \f[
+      \theta R \frac{\partial C}{\partial t} = \frac{1}{r}\frac{\partial}
+      {\partial r}\left(r\theta D\frac{\partial C}{\partial r} - r\theta vC
+      \right), \qquad R = 1 + \frac{\rho K_d}{\theta}
+   \f]
+   is advanced implicitly over the cells with a finite volume scheme,
+   upwinding the advection. Since the scheme is implicit, the timestep is
+   not limited by the cell size. The tridiagonal system of each isotope is
+   solved by the Thomas algorithm, for all isotopes at once.
+
+   Material enters the component through the innermost cell. The outer
+   boundary is closed during the step, and the contents of the outermost
+   cell are offered as the source term, so that material leaves the
+   component when the next component extracts it.
+
+   The RadialFVNuclide model can be used to represent nuclide models of the
+   disposal system such as the Buffer and the Near Field, where the
+   concentration varies across the component.
+ */
+class RadialFVNuclide : public NuclideModel, public PoolAlloc<RadialFVNuclide> {
+  /*----------------------------*/
+  /* All NuclideModel classes   */
+  /* have the following members */
+  /*----------------------------*/
+private:
+
+  /**
+     Default constructor for the nuclide model class. Creates an empty nuclide model.
+   */
+  RadialFVNuclide();
+
+  /**
+     primary constructor reads input from the QueryEngine
+
+     @param qe is the QueryEngine object containing intialization info
+   */
+  RadialFVNuclide(QueryEngine* qe);
+
+  /**
+     Constructs a copy of a template model, sharing its parameters, without 
+     the default geometry made only to be replaced. Use create(src).
+
+     @param src the template model to copy
+   */
+  RadialFVNuclide(const RadialFVNuclide& src);
+
+  /// sets up this model as a copy of src, for copy() and create(src)
+  void copy_from(const RadialFVNuclide& src);
+
+public:
+
+  /**
+     A constructor for the Radial FV Nuclide Model that returns a shared pointer.
+    */
+  static RadialFVNuclidePtr create (){ return share(new RadialFVNuclide()); };
+
+  /**
+     A constructor for the Radial FV Nuclide Model that returns a shared pointer.
+
+     @param qe is the QueryEngine object containing intialization info
+    */
+  static RadialFVNuclidePtr create (QueryEngine* qe){ return share(new RadialFVNuclide(qe)); };
+
+  /**
+     A constructor for the RadialFV Nuclide Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static RadialFVNuclidePtr create(const RadialFVNuclide& src){ return share(new RadialFVNuclide(src)); };
+
+  /**
+     Virtual destructor deletes datamembers that are object pointers.
+    */
+  virtual ~RadialFVNuclide();
+
+  /**
+     initializes the model parameters from a QueryEngine object
+
+     @param qe is the QueryEngine object containing intialization info
+   */
+  virtual void initModuleMembers(QueryEngine* qe);
+
+  /**
+     copies a nuclide model and its parameters from another
+
+     @param src is the nuclide model being copied
+   */
+  virtual NuclideModelPtr copy(const NuclideModel& src);
+
+  /**
+     standard verbose printer includes current temp and concentrations
+   */
+  virtual void print();
+
+  /**
+     Absorbs the contents of the given Material into the innermost cell of
+     this RadialFVNuclide.
+
+     @param matToAdd the Material to be absorbed
+   */
+  virtual void absorb(mat_rsrc_ptr matToAdd) ;
+
+  /**
+     Extracts the contents of the given Material from this RadialFVNuclide,
+     from the outermost cell inward.
+
+     @param comp_to_rem the composition to decrement against this RadialFVNuclide
+     @param kg_to_rem the amount in kg to decrement against this RadialFVNuclide
+
+     @return the material extracted
+   */
+  virtual mat_rsrc_ptr extract(CompMapPtr comp_to_rem, double kg_to_rem );
+
+  /**
+     Transports nuclides across the cells, from the last time it was
+     updated until the time given
+
+     @param time the timestep at which to transport the nuclides
+   */
+  virtual void transportNuclides(int time);
+
+  /**
+     Determines what IsoVector to remove from the daughter nuclide models
+
+     @param time the timestep at which the nuclides should be transported
+     @param daughter nuclide_model of an internal component. there may be many.
+    */
+  void update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters);
+
+  /**
+     Returns the nuclide model type
+   */
+  virtual NuclideModelType type(){return RADIALFV_NUCLIDE;};
+
+  /**
+     Returns the nuclide model type name
+   */
+  virtual std::string name(){return "RADIALFV_NUCLIDE";};
+
+  /**
+     Updates all the hists
+
+     @param the_time the time at which to update the history
+   */
+  virtual void update(int the_time);
+
+  /**
+     returns the available material source term at the outer boundary of the
+     component, the contents of the outermost cell
+   *
+     @return the IsoVector and mass in the outermost cell
+   */
+  virtual std::pair<IsoVector, double> source_term_bc();
+
+  /**
+     returns the prescribed concentration at the boundary, the dirichlet bc
+     in kg/m^3, the dissolved concentration in the outermost cell
+   *
+     @return C the concentration at the boundary in kg/m^3 for each isotope
+   */
+  virtual IsoConcMap dirichlet_bc();
+
+  /**
+     returns the concentration gradient at the boundary, the Neumann bc,
+     from the middle of the outermost cell
+   *
+     @return dCdx the concentration gradient at the boundary in kg/m^3
+   */
+  virtual ConcGradMap neumann_bc(IsoConcMap c_ext, Radius r_ext);
+
+  /**
+     returns the flux at the boundary, the Neumann bc
+   *
+     @return qC the solute flux at the boundary in kg/m^2/s
+   */
+  virtual IsoFluxMap cauchy_bc(IsoConcMap c_ext, Radius r_ext);
+
+  /**
+     Replaces the contained masses, scaling the mass of each isotope in
+     every cell alike. An isotope that is new to the component is spread
+     like the rest of the contents.
+
+     @param masses the new mass of each isotope [kg]
+   */
+  virtual void set_iso_masses(const IsoMassMap& masses);
+
+  /**
+     Decays the contained masses over a step, and scales the cells to 
+     them.
+
+     @param decay the decay data
+     @param dt the length of the step [timesteps]
+   */
+  virtual void decay(DecayOperator& decay, int dt);
+
+  /*----------------------------*/
+  /* This NuclideModel class    */
+  /* has the following members  */
+  /*----------------------------*/
+public:
+  /**
+     updates the contained concentration history with the dissolved
+     concentration in the outermost cell
+
+     @param the_time the time at which to update the concentration
+     @return the current isotopic concentration map at the outer border
+    */
+  IsoConcMap update_conc_hist(int the_time);
+
+  /**
+     Updates the isotopic vector history at the time
+
+     @param the_time the time at which to update the vector history
+     */
+  void update_vec_hist(int the_time);
+
+  /**
+     The dissolved concentration of each isotope in a cell [kg/m^3]
+
+     @param cell the index of the cell, 0 is innermost
+     @throws CycRangeException if there is no such cell
+    */
+  IsoConcMap cell_conc(int cell);
+
+  /**
+     The contained mass of each isotope in a cell [kg]
+
+     @param cell the index of the cell, 0 is innermost
+     @throws CycRangeException if there is no such cell
+    */
+  IsoMassMap cell_masses(int cell);
+
+  /**
+     The radius of the middle of a cell [m]
+
+     @param cell the index of the cell, 0 is innermost
+    */
+  Radius cell_midpoint(int cell);
+
+  /**
+    Set the number of cells across the component. The contained mass is
+    moved to the innermost cell.
+
+    @throws CycRangeException if n_cells is less than one
+   */
+  void set_n_cells(int n_cells);
+
+  /**
+    The number of cells across the component.
+   */
+  const int n_cells() const {return params_->n_cells;};
+
+  /**
+    Set the porosity (a fraction) of the material of this component. [%]
+   */
+  void set_porosity(double porosity);
+
+  /**
+    The porosity (a fraction) of the material of this component. [%]
+   */
+  const double porosity() const {return params_->porosity;};
+
+  /**
+    Set the dry bulk density of the material of this component. [kg/m^3]
+   */
+  void set_rho(double rho);
+
+  /**
+    The dry bulk density of the material of this component. [kg/m^3]
+   */
+  const double rho() const {return params_->rho;};
+
+  /**
+    Set the advective velocity through this component. [m/s]
+   */
+  void set_v(double v){params_.write().v = v; invalidate_bcs();};
+
+  /**
+    The advective velocity through this component. [m/s]
+   */
+  const double v() const {return params_->v;};
+
+  /// Gets the total volume
+  double V_T();
+
+  /// Gets the fluid volume, based on porosity
+  double V_f();
+
+protected:
+  /**
+     brings the cells into agreement with iso_masses_, which absorb and
+     extract change. Mass that was added goes to the innermost cell, and
+     mass that was removed comes from the outermost cells first.
+   */
+  void sync_cells();
+
+  /**
+     widens the columns of the cells to the isotopes of iso_masses_, 
+     without moving any mass
+   */
+  void remap_cells();
+
+  /**
+     advances the concentrations in the cells by one implicit step
+
+     @param dt the length of the step [timesteps]
+   */
+  void step(int dt);
+
+  /**
+     the volume of a cell, in which the fluid is porosity() of it [m^3]
+
+     @param cell the index of the cell, 0 is innermost
+   */
+  double cell_volume(int cell);
+
+  /**
+     the retardation factor of an isotope, 1 + rho K_d / porosity
+
+     @param tope the isotope
+   */
+  double retardation(Iso tope);
+
+  /// throws if there is no such cell
+  void validate_cell(int cell);
+
+  /// the parameters of a RadialFVNuclide, which its copies share
+  struct Params {
+    /// Constructor, for the default parameters
+    Params() : v(0), porosity(0), rho(0), n_cells(1) {};
+
+    /// The advective velocity through this component [m/s]
+    double v;
+
+    /// The porosity of the material in the component, a fraction [%]
+    double porosity;
+
+    /// The dry bulk density of the material in the component [kg/m^3]
+    double rho;
+
+    /// The number of cells across the component
+    int n_cells;
+  };
+
+  /// the parameters, shared with the template until one is set
+  SharedParams<Params> params_;
+
+  /// The isotopes of the columns of cell_masses_, sorted
+  std::vector<Iso> isos_;
+
+  /// The mass of each isotope in each cell, n_cells() x isos_.size() [kg]
+  std::vector<double> cell_masses_;
+
+};
+#endif
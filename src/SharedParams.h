@@ -0,0 +1,63 @@
+/*! \file SharedParams.h
+  \brief Declares the SharedParams class template used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_SHAREDPARAMS_H)
+#define _SHAREDPARAMS_H
+
+#include <boost/shared_ptr.hpp>
+
+/**
+   @brief SharedParams holds the parameters of a model, shared by all of the
+   copies of the template the model was copied from.
+
+   The parameters of a model, such as its porosity or degradation rate, are
+   read from the input for a template, and every component copied from the
+   template has the same ones. Copying a SharedParams shares the one block of
+   parameters rather than copying it, so that a copy costs no allocation and
+   the components don't each keep the same numbers.
+
+   The parameters are read through ->, and changed through write(), which
+   first gives this model a copy of its own if the block is shared. Setting a
+   parameter of one component therefore never changes another.
+
+   P must be copy constructible, and its default constructor gives the
+   defaults of the model.
+ */
+template <class P>
+class SharedParams {
+public:
+  /// Constructor, for a block of its own with the default parameters
+  SharedParams() : params_(new P()) {};
+
+  /// reads the parameters
+  const P* operator->() const {return params_.get();};
+
+  /// reads the parameters
+  const P& operator*() const {return *params_;};
+
+  /**
+     the parameters to change, copied first if they are shared with another
+     model
+   */
+  P& write(){
+    if( !params_.unique() ){
+      params_.reset(new P(*params_));
+    }
+    return *params_;
+  };
+
+  /// true if these are the very parameters of other, rather than a copy
+  bool shares(const SharedParams<P>& other) const {
+    return params_ == other.params_;
+  };
+
+  /// the number of models sharing these parameters
+  long use_count() const {return params_.use_count();};
+
+private:
+  /// the block of parameters
+  boost::shared_ptr<P> params_;
+};
+
+#endif
@@ -17,6 +17,7 @@ using namespace std;
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StubNuclide::StubNuclide(){
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   set_geom(GeometryPtr(new Geometry()));
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
@@ -25,6 +26,7 @@ StubNuclide::StubNuclide(){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 StubNuclide::StubNuclide(QueryEngine* qe){
   wastes_ = deque<mat_rsrc_ptr>();
+  wastes_current_ = true;
   set_geom(GeometryPtr(new Geometry()));
   vec_hist_ = VecHist();
   conc_hist_ = ConcHist();
@@ -59,6 +61,7 @@ void StubNuclide::absorb(mat_rsrc_ptr matToAdd)
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRSNuc") << "StubNuclide is absorbing material: ";
   matToAdd->print();
+  absorb_mat(matToAdd);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -69,7 +72,7 @@ mat_rsrc_ptr StubNuclide::extract(const CompMapPtr comp_to_rem, double kg_to_rem
   // each nuclide model should override this function
   LOG(LEV_DEBUG2,"GRSNuc") << "StubNuclide" << "is extracting composition: ";
   comp_to_rem->print() ;
-  mat_rsrc_ptr to_ret = mat_rsrc_ptr(MatTools::extract(comp_to_rem, kg_to_rem, wastes_));
+  mat_rsrc_ptr to_ret = extract_mat(comp_to_rem, kg_to_rem);
   update(TI->time());
   return to_ret;
 }
@@ -90,9 +93,9 @@ void StubNuclide::update(int the_time){
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
-void StubNuclide::update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters){
+void StubNuclide::update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters){
   std::map<NuclideModelPtr, std::pair<IsoVector,double> > to_ret;
-  std::vector<NuclideModelPtr>::iterator daughter;
+  std::vector<NuclideModelPtr>::const_iterator daughter;
   std::pair<IsoVector, double> source_term;
   for( daughter = daughters.begin(); daughter!=daughters.end(); ++daughter){
     source_term = (*daughter)->source_term_bc();
@@ -112,17 +115,17 @@ pair<IsoVector, double> StubNuclide::source_term_bc(){
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoConcMap StubNuclide::dirichlet_bc(){
   /// @TODO This is just a placeholder
-  return conc_hist_.at(TI->time());
+  return conc_hist_.map(TI->time());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 ConcGradMap StubNuclide::neumann_bc(IsoConcMap c_ext, Radius r_ext){
   /// @TODO This is just a placeholder
-  return conc_hist_.at(TI->time());
+  return conc_hist_.map(TI->time());
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 IsoFluxMap StubNuclide::cauchy_bc(IsoConcMap c_ext, Radius r_ext){
   /// @TODO This is just a placeholder
-  return conc_hist_.at(TI->time());
+  return conc_hist_.map(TI->time());
 }
@@ -12,6 +12,7 @@
 #include <string>
 
 #include "NuclideModel.h"
+#include "PoolAlloc.h"
 
 
 /// A shared pointer for the StubNuclide object
@@ -28,7 +29,7 @@ typedef boost::shared_ptr<StubNuclide> StubNuclidePtr;
    disposal system such as the Waste Form, Waste Package, Buffer, Near Field,
    Far Field, and Envrionment.
  */
-class StubNuclide : public NuclideModel {
+class StubNuclide : public NuclideModel, public PoolAlloc<StubNuclide> {
 private:
   
   /**
@@ -52,14 +53,23 @@ public:
   /**
      A constructor for the Stub Nuclide Model that returns a shared pointer.
     */
-  static StubNuclidePtr create (){ return StubNuclidePtr(new StubNuclide()); };
+  static StubNuclidePtr create (){ return share(new StubNuclide()); };
 
   /**
      A constructor for the Stub Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static StubNuclidePtr create (QueryEngine* qe){ return StubNuclidePtr(new StubNuclide(qe)); };
+  static StubNuclidePtr create (QueryEngine* qe){ return share(new StubNuclide(qe)); };
+
+  /**
+     A constructor for the Stub Nuclide Model that returns a shared pointer 
+     to a copy of a template. The stub has no parameters, so this is an 
+     empty model.
+
+     @param src the template model to copy
+    */
+  static StubNuclidePtr create (const StubNuclide& src){ return create(); };
 
   /**
      initializes the model parameters from an xmlNodePtr
@@ -114,7 +124,7 @@ public:
      @param daughter nuclide_model of an internal component. there may be many.
      
      */
-  void update_inner_bc(int the_time, std::vector<NuclideModelPtr> daughters); 
+  void update_inner_bc(int the_time, const std::vector<NuclideModelPtr>& daughters); 
 
   /**
      Returns the nuclide model type
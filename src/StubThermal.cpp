@@ -29,6 +29,7 @@ StubThermalPtr StubThermal::deepCopy(){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StubThermal::copy(ThermalModelPtr src){
+  copy_limits(*src);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -44,10 +45,7 @@ void StubThermal::transportHeat(int time){
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 Temp StubThermal::peak_temp(){
-  TempHist::iterator start = temp_hist_.begin();
-  TempHist::iterator stop = temp_hist_.end();
-  TempHist::iterator max = max_element(start, stop);
-  return (*max).second;
+  return peak_temp_;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "ThermalModel.h"
+#include "PoolAlloc.h"
 
 /// A shared pointer for the StubThermal object
 class StubThermal;
@@ -25,7 +26,7 @@ typedef boost::shared_ptr<StubThermal> StubThermalPtr;
    disposal system such as the Waste Form, Waste Package, Buffer, Near Field,
    Far Field, and Envrionment.
  */
-class StubThermal : public ThermalModel {
+class StubThermal : public ThermalModel, public PoolAlloc<StubThermal> {
 public:
   
   /**
@@ -40,6 +41,13 @@ public:
    */
   StubThermal(QueryEngine* qe){};
 
+  /**
+     Constructs a copy of a template model, with its limits. Use create(src).
+
+     @param src the template model to copy
+   */
+  StubThermal(const StubThermal& src){ copy_limits(src); };
+
   /** 
      Default destructor does nothing.
    */
@@ -48,14 +56,22 @@ public:
   /**
      A constructor for the Lumped Nuclide Model that returns a shared pointer.
     */
-  static ThermalModelPtr create (){ return ThermalModelPtr(new StubThermal()); };
+  static ThermalModelPtr create (){ return share(new StubThermal()); };
 
   /**
      A constructor for the Lumped Nuclide Model that returns a shared pointer.
 
      @param qe is the QueryEngine object containing intialization info
     */
-  static ThermalModelPtr create (QueryEngine* qe){ return ThermalModelPtr(new StubThermal(qe)); };
+  static ThermalModelPtr create (QueryEngine* qe){ return share(new StubThermal(qe)); };
+
+  /**
+     A constructor for the Stub Thermal Model that returns a shared pointer 
+     to a copy of a template, as copy() would make it.
+
+     @param src the template model to copy
+    */
+  static ThermalModelPtr create (const StubThermal& src){ return share(new StubThermal(src)); };
 
   /**
      initializes the model parameters from an xmlNodePtr
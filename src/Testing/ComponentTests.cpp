@@ -88,3 +88,126 @@ TEST_F(ComponentTest, copy) {
   EXPECT_EQ("STUB_THERMAL", test_copy->thermal_model()->name());
   EXPECT_EQ("DEGRATE_NUCLIDE", test_copy->nuclide_model()->name());
 }
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, template_id) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  EXPECT_EQ(test_component_->ID(), test_component_->template_id());
+
+  ComponentPtr test_copy = ComponentPtr(new Component());
+  EXPECT_NO_THROW(test_copy->copy(test_component_));
+  EXPECT_NE(test_component_->ID(), test_copy->ID());
+  EXPECT_EQ(test_component_->ID(), test_copy->template_id());
+
+  // a copy of a copy still shares the original template
+  ComponentPtr test_copy_copy = ComponentPtr(new Component());
+  EXPECT_NO_THROW(test_copy_copy->copy(test_copy));
+  EXPECT_EQ(test_component_->ID(), test_copy_copy->template_id());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, create_from_template) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  ComponentPtr test_copy;
+  ASSERT_NO_THROW(test_copy = Component::create(test_component_));
+  EXPECT_EQ(name_, test_copy->name());
+  EXPECT_EQ(type_, test_copy->type());
+  EXPECT_EQ(inner_radius_, test_copy->inner_radius());
+  EXPECT_EQ(outer_radius_, test_copy->outer_radius());
+  EXPECT_EQ("STUB_THERMAL", test_copy->thermal_model()->name());
+  EXPECT_EQ("DEGRATE_NUCLIDE", test_copy->nuclide_model()->name());
+  EXPECT_NE(thermal_model_, test_copy->thermal_model());
+  EXPECT_NE(nuclide_model_, test_copy->nuclide_model());
+  EXPECT_NE(test_component_->ID(), test_copy->ID());
+  EXPECT_EQ(test_component_->ID(), test_copy->template_id());
+  EXPECT_FLOAT_EQ(OneHundredCinK, test_copy->temp_lim());
+
+  // the geometry is the template's until the copy is placed
+  EXPECT_EQ(test_component_->geom(), test_copy->geom());
+  EXPECT_EQ(test_component_->geom(), test_copy->nuclide_model()->geom());
+  point_t placed = {1, 2, 3};
+  test_copy->setPlacement(placed, 4);
+  EXPECT_NE(test_component_->geom(), test_copy->geom());
+  EXPECT_EQ(test_copy->geom(), test_copy->nuclide_model()->geom());
+  EXPECT_FLOAT_EQ(1, test_copy->x());
+  EXPECT_FLOAT_EQ(4, test_copy->nuclide_model()->geom()->length());
+  EXPECT_FLOAT_EQ(0, test_component_->x());
+  EXPECT_EQ(outer_radius_, test_copy->outer_radius());
+
+  // pooled components are released like any other
+  ComponentPtr empty = Component::create();
+  EXPECT_EQ(LAST_EBS, empty->type());
+  EXPECT_NO_THROW(empty.reset());
+  EXPECT_NO_THROW(test_copy.reset());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, daughters) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  EXPECT_TRUE(test_component_->daughters().empty());
+  EXPECT_TRUE(test_component_->nuclide_daughters().empty());
+
+  ComponentPtr first = Component::create(test_component_);
+  ComponentPtr second = Component::create(test_component_);
+  test_component_->load(WP, first);
+  const vector<NuclideModelPtr>& models = test_component_->nuclide_daughters();
+  ASSERT_EQ(1, models.size());
+  EXPECT_EQ(first->nuclide_model(), models[0]);
+  // the list is kept, and made again when the tree changes
+  EXPECT_EQ(&models, &test_component_->nuclide_daughters());
+  test_component_->load(WP, second);
+  ASSERT_EQ(2, test_component_->nuclide_daughters().size());
+  EXPECT_EQ(second->nuclide_model(), test_component_->nuclide_daughters()[1]);
+  EXPECT_EQ(2, test_component_->daughters().size());
+  EXPECT_EQ(second, test_component_->daughters()[1]);
+  // or a daughter is given another model
+  NuclideModelPtr replacement = StubNuclide::create();
+  second->set_nuclide_model(replacement);
+  EXPECT_EQ(replacement, test_component_->nuclide_daughters()[1]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(ComponentTest, occupancy) {
+  EXPECT_NO_THROW(test_component_->init(name_, type_, mat_, inner_radius_, outer_radius_, 
+        thermal_model_, nuclide_model_));
+  point_t origin = {0, 0, 0};
+  test_component_->setPlacement(origin, 10);
+  EXPECT_FLOAT_EQ(0, test_component_->occupied_length());
+  EXPECT_FLOAT_EQ(10, test_component_->remaining_capacity());
+  EXPECT_FALSE(test_component_->isFull());
+
+  // the occupied length follows the daughters as they are loaded and placed
+  ComponentPtr first = Component::create(test_component_);
+  first->set_type(WP);
+  test_component_->load(WP, first);
+  first->setPlacement(origin, 4);
+  EXPECT_FLOAT_EQ(4, test_component_->occupied_length());
+  EXPECT_FLOAT_EQ(6, test_component_->remaining_capacity());
+  EXPECT_FALSE(test_component_->isFull());
+  ComponentPtr second = Component::create(test_component_);
+  second->set_type(WP);
+  test_component_->load(WP, second);
+  second->setPlacement(origin, 7);
+  EXPECT_FLOAT_EQ(11, test_component_->occupied_length());
+  EXPECT_FLOAT_EQ(0, test_component_->remaining_capacity());
+  EXPECT_TRUE(test_component_->isFull());
+  second->setPlacement(origin, 5);
+  EXPECT_FLOAT_EQ(1, test_component_->remaining_capacity());
+  EXPECT_FALSE(test_component_->isFull());
+
+  // other components hold only what they are loaded with
+  EXPECT_TRUE(first->isFull());
+  EXPECT_FLOAT_EQ(0, first->remaining_capacity());
+
+  // so placing a waste form in a package changes neither it nor the buffer
+  ComponentPtr wf = Component::create(test_component_);
+  wf->set_type(WF);
+  first->load(WF, wf);
+  wf->setPlacement(origin, 4);
+  EXPECT_FLOAT_EQ(0, first->occupied_length());
+  EXPECT_FLOAT_EQ(0, first->remaining_capacity());
+  EXPECT_FLOAT_EQ(1, test_component_->remaining_capacity());
+}
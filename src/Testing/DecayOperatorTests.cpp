@@ -0,0 +1,169 @@
+// DecayOperatorTests.cpp
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include "CycException.h"
+#include "SqliteDb.h"
+#include "DecayOperator.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class DecayOperatorTest : public ::testing::Test {
+  protected:
+    DecayOperatorPtr decay_;
+    vector<IsoMassMap> masses_;
+    int u235_, th231_, pa231_, u238_;
+    double month_, lambda_a_, lambda_b_;
+
+    virtual void SetUp(){
+      u235_ = 92235;
+      th231_ = 90231;
+      pa231_ = 91231;
+      u238_ = 92238;
+      month_ = DecayOperator::SECS_PER_TIMESTEP;
+      lambda_a_ = log(2.0)/month_;
+      lambda_b_ = log(2.0)/(3*month_);
+      // a short chain with made up half lives, u235 -> th231 -> pa231
+      decay_ = DecayOperatorPtr(new DecayOperator());
+      decay_->addLink(u235_, month_, th231_, 1);
+      decay_->addLink(th231_, 3*month_, pa231_, 1);
+      masses_.resize(2);
+      masses_[0][u235_] = 8;
+      masses_[1][u235_] = 2;
+      masses_[1][u238_] = 5;
+    }
+    virtual void TearDown() {
+    }
+
+    double bateman(double m_0, int dt){
+      double t = dt*month_;
+      return m_0*lambda_a_/(lambda_b_ - lambda_a_)*
+        (exp(-lambda_a_*t) - exp(-lambda_b_*t));
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, empty) {
+  DecayOperator none;
+  EXPECT_EQ(0, none.n_isos());
+  EXPECT_NO_THROW(none.apply(masses_, 1));
+  EXPECT_FLOAT_EQ(8, masses_[0][u235_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, load_missing) {
+  namespace fs = boost::filesystem;
+  EXPECT_THROW(DecayOperator::load("./no_such_mat_data.sqlite"), CycException);
+  // a database of materials alone has no decay data
+  std::string path = (fs::temp_directory_path() / 
+      fs::unique_path("cyder-%%%%-%%%%.sqlite")).string();
+  {
+    SqliteDb db(path);
+    db.execute("CREATE TABLE clay (elem INTEGER, d REAL, k_d REAL, s REAL)");
+  }
+  EXPECT_THROW(DecayOperator::load(path), CycException);
+  fs::remove(path);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, load) {
+  namespace fs = boost::filesystem;
+  std::string path = (fs::temp_directory_path() / 
+      fs::unique_path("cyder-%%%%-%%%%.sqlite")).string();
+  {
+    SqliteDb db(path);
+    db.execute("CREATE TABLE decay (parent INTEGER, daughter INTEGER, "
+        "half_life REAL, branch_ratio REAL)");
+    db.execute("INSERT INTO decay VALUES (92235, 90231, 2629800.0, 1.0)");
+    db.execute("INSERT INTO decay VALUES (90231, 0, 7889400.0, 1.0)");
+  }
+  DecayOperatorPtr loaded = DecayOperator::load(path);
+  EXPECT_EQ(2, loaded->n_isos());
+  loaded->apply(masses_, 1);
+  EXPECT_NEAR(4, masses_[0][u235_], 1e-9);
+  // a daughter of 0 leaves the tracked isotopes
+  EXPECT_GT(4, masses_[0][th231_]);
+  fs::remove(path);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, addLink) {
+  EXPECT_EQ(3, decay_->n_isos());
+  EXPECT_THROW(decay_->addLink(u238_, 0, th231_, 1), CycRangeException);
+  EXPECT_THROW(decay_->addLink(u238_, month_, th231_, 2), CycRangeException);
+  // every link of a parent has the same half life
+  EXPECT_THROW(decay_->addLink(u235_, 2*month_, u238_, 0.5), 
+      CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, chain) {
+  decay_->apply(masses_, 1);
+  EXPECT_NEAR(4, masses_[0][u235_], 1e-9);
+  EXPECT_NEAR(bateman(8, 1), masses_[0][th231_], 1e-9);
+  EXPECT_NEAR(8, masses_[0][u235_] + masses_[0][th231_] + masses_[0][pa231_],
+      1e-9);
+  // every composition is decayed by the same pass
+  EXPECT_NEAR(1, masses_[1][u235_], 1e-9);
+  EXPECT_NEAR(bateman(2, 1), masses_[1][th231_], 1e-9);
+  // isotopes without decay data are stable
+  EXPECT_FLOAT_EQ(5, masses_[1][u238_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, cache) {
+  vector<IsoMassMap> once(masses_);
+  decay_->apply(masses_, 1);
+  decay_->apply(masses_, 1);
+  EXPECT_EQ(1, decay_->n_cached());
+  decay_->apply(once, 2);
+  EXPECT_EQ(2, decay_->n_cached());
+  EXPECT_NEAR(once[0][th231_], masses_[0][th231_], 1e-9);
+  EXPECT_NEAR(once[0][pa231_], masses_[0][pa231_], 1e-9);
+  // new links invalidate the propagators
+  decay_->addLink(pa231_, 10*month_, 0, 1);
+  EXPECT_EQ(0, decay_->n_cached());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, stiff) {
+  // a daughter that lives for a second comes into equilibrium with its 
+  // parent within the step, and never goes negative
+  decay_->addLink(pa231_, 1, u238_, 1);
+  decay_->apply(masses_, 12);
+  double pa = masses_[0][pa231_];
+  EXPECT_GT(pa, 0);
+  EXPECT_GE(masses_[0][u238_], 0);
+  double total = masses_[0][u235_] + masses_[0][th231_] + pa + 
+    masses_[0][u238_];
+  EXPECT_NEAR(8, total, 1e-6);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, cycle) {
+  decay_->addLink(pa231_, month_, u235_, 1);
+  EXPECT_THROW(decay_->apply(masses_, 1), CycException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(DecayOperatorTest, in_place) {
+  // one composition decays as it does among many
+  IsoMassMap one = masses_[1];
+  decay_->apply(one, 1);
+  decay_->apply(masses_, 1);
+  EXPECT_EQ(masses_[1].size(), one.size());
+  IsoMassMap::const_iterator it;
+  for(it = one.begin(); it != one.end(); ++it){
+    EXPECT_NEAR(masses_[1][(*it).first], (*it).second, 1e-9);
+  }
+  EXPECT_FLOAT_EQ(5, one[u238_]);
+  // and stable contents are left alone, without daughters
+  IsoMassMap stable;
+  stable[u238_] = 5;
+  decay_->apply(stable, 1);
+  EXPECT_EQ(1, stable.size());
+  EXPECT_FLOAT_EQ(5, stable[u238_]);
+}
@@ -98,6 +98,37 @@ TEST_F(DegRateNuclideTest, copy) {
   EXPECT_FLOAT_EQ(deg_rate_, test_copy->deg_rate());
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(DegRateNuclideTest, create_from_template) {
+  DegRateNuclidePtr test_copy = DegRateNuclide::create(*deg_rate_ptr_);
+  EXPECT_FLOAT_EQ(deg_rate_, test_copy->deg_rate());
+  EXPECT_FLOAT_EQ(adv_vel_, test_copy->v());
+  EXPECT_FLOAT_EQ(0, test_copy->tot_deg());
+  // the geometry is the template's, and nothing is updated until it's used
+  EXPECT_EQ(deg_rate_ptr_->geom(), test_copy->geom());
+  EXPECT_TRUE(test_copy->vec_hist().empty());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(DegRateNuclideTest, shared_params) {
+  // copies share the parameters of the template until one of them is set
+  DegRateNuclidePtr first = DegRateNuclide::create();
+  DegRateNuclidePtr second = DegRateNuclide::create();
+  first->copy(*deg_rate_ptr_);
+  second->copy(*deg_rate_ptr_);
+  first->set_deg_rate(0.5);
+  EXPECT_FLOAT_EQ(0.5, first->deg_rate());
+  EXPECT_FLOAT_EQ(deg_rate_, second->deg_rate());
+  EXPECT_FLOAT_EQ(deg_rate_, deg_rate_ptr_->deg_rate());
+  // nor does the template change its copies
+  deg_rate_ptr_->set_v(2*adv_vel_);
+  EXPECT_FLOAT_EQ(adv_vel_, second->v());
+  EXPECT_FLOAT_EQ(2*adv_vel_, deg_rate_ptr_->v());
+  // the state of each copy is its own
+  first->set_tot_deg(0.25);
+  EXPECT_FLOAT_EQ(0, second->tot_deg());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(DegRateNuclideTest, absorb){
   //@TODO tests like this should be interface tests for the NuclideModel class concrete instances.
@@ -112,6 +143,51 @@ TEST_F(DegRateNuclideTest, absorb){
   }
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(DegRateNuclideTest, iso_masses){
+  // the running isotopic masses follow what is absorbed and extracted
+  CompMapPtr u238_comp = CompMapPtr(new CompMap(MASS));
+  (*u238_comp)[92238] = 1;
+  mat_rsrc_ptr u238_mat = mat_rsrc_ptr(new Material(u238_comp));
+  u238_mat->setQuantity(3*test_size_);
+
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(u238_mat));
+  EXPECT_FLOAT_EQ(test_size_, nuc_model_ptr_->iso_masses().find(u235_)->second);
+  EXPECT_FLOAT_EQ(3*test_size_, nuc_model_ptr_->iso_masses().find(92238)->second);
+
+  EXPECT_NO_THROW(deg_rate_ptr_->update_vec_hist(time_));
+  EXPECT_FLOAT_EQ(4*test_size_, nuc_model_ptr_->contained_mass(time_));
+  EXPECT_FLOAT_EQ(0.25, nuc_model_ptr_->vec_hist().at(time_, u235_));
+  EXPECT_FLOAT_EQ(0.75, nuc_model_ptr_->vec_hist().at(time_, 92238));
+
+  EXPECT_NO_THROW(nuc_model_ptr_->extract(test_comp_, test_size_/2));
+  EXPECT_FLOAT_EQ(test_size_/2, nuc_model_ptr_->iso_masses().find(u235_)->second);
+  EXPECT_FLOAT_EQ(3*test_size_, nuc_model_ptr_->iso_masses().find(92238)->second);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(DegRateNuclideTest, extract_isos){
+  // several isotopes are extracted at once, as one material
+  CompMapPtr u238_comp = CompMapPtr(new CompMap(MASS));
+  (*u238_comp)[92238] = 1;
+  mat_rsrc_ptr u238_mat = mat_rsrc_ptr(new Material(u238_comp));
+  u238_mat->setQuantity(test_size_);
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(u238_mat));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
+  EXPECT_EQ(1, nuc_model_ptr_->wastes().size());
+
+  IsoMassMap kgs;
+  kgs[u235_] = test_size_/2;
+  kgs[92238] = test_size_/5;
+  mat_rsrc_ptr got;
+  EXPECT_NO_THROW(got = nuc_model_ptr_->extract_isos(kgs));
+  EXPECT_FLOAT_EQ(0.7*test_size_, got->mass(MassUnit(KG)));
+  EXPECT_FLOAT_EQ(1.3*test_size_, nuc_model_ptr_->contained_mass(time_));
+  EXPECT_FLOAT_EQ(1.3*test_size_, nuc_model_ptr_->wastes().front()->mass(MassUnit(KG)));
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(DegRateNuclideTest, extract){ 
   //@TODO tests like this should be interface tests for the NuclideModel class concrete instances.
@@ -338,6 +414,37 @@ TEST_F(DegRateNuclideTest, transportNuclidesDR1){
   EXPECT_FLOAT_EQ(0, nuc_model_ptr_->source_term_bc().second);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(DegRateNuclideTest, cached_bcs){ 
+  // the cached bcs must follow the degradation, and the external conditions
+  deg_rate_= 0.5;
+  EXPECT_NO_THROW(deg_rate_ptr_->set_geom(geom_));
+  ASSERT_NO_THROW(deg_rate_ptr_->set_deg_rate(deg_rate_));
+  EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(++time_));
+  double conc = test_size_/(nuc_model_ptr_->geom()->volume());
+  double outer_radius = nuc_model_ptr_->geom()->outer_radius();
+  IsoConcMap zero_conc_map;
+  zero_conc_map[92235] = 0;
+
+  EXPECT_FLOAT_EQ(deg_rate_*conc, nuc_model_ptr_->dirichlet_bc(u235_));
+  double flux = nuc_model_ptr_->cauchy_bc(zero_conc_map, outer_radius*2, u235_);
+  EXPECT_FLOAT_EQ(flux, nuc_model_ptr_->cauchy_bcs(zero_conc_map, outer_radius*2).find(u235_)->second);
+
+  // new external conditions are a new evaluation
+  double grad = nuc_model_ptr_->neumann_bc(zero_conc_map, outer_radius*2, u235_);
+  EXPECT_NE(grad, nuc_model_ptr_->neumann_bc(zero_conc_map, outer_radius*3, u235_));
+
+  // changing the degradation discards the cache
+  deg_rate_ptr_->set_tot_deg(1);
+  EXPECT_FLOAT_EQ(conc, nuc_model_ptr_->dirichlet_bc(u235_));
+  EXPECT_NE(flux, nuc_model_ptr_->cauchy_bc(zero_conc_map, outer_radius*2, u235_));
+
+  // as does the next transport
+  EXPECT_NO_THROW(nuc_model_ptr_->transportNuclides(++time_));
+  EXPECT_FLOAT_EQ(conc, nuc_model_ptr_->dirichlet_bc(u235_));
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(DegRateNuclideTest, transportNuclidesDRsmall){ 
   // if the degradation rate is very very small, see if the model behaves well 
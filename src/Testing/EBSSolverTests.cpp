@@ -0,0 +1,170 @@
+// EBSSolverTests.cpp
+#include <deque>
+#include <gtest/gtest.h>
+
+#include "Component.h"
+#include "CycException.h"
+#include "DegRateNuclide.h"
+#include "EBSSolver.h"
+#include "TockScheduler.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+class EBSSolverTest : public ::testing::Test {
+  protected:
+    EBSSolverPtr solver_;
+    TockSchedulerPtr sched_;
+    deque<ComponentPtr> wfs_, wps_, buffers_;
+    ComponentPtr ff_;
+    CompMapPtr test_comp_;
+    mat_rsrc_ptr test_mat_;
+    int u235_, time_;
+    double test_size_;
+
+    virtual void SetUp(){
+      u235_ = 92235;
+      time_ = 0;
+      test_size_ = 10.0;
+      test_comp_ = CompMapPtr(new CompMap(MASS));
+      (*test_comp_)[u235_] = 1;
+      test_mat_ = mat_rsrc_ptr(new Material(test_comp_));
+      test_mat_->setQuantity(test_size_);
+
+      // build a chain, ff <- buffer <- wp <- wf
+      ff_ = makeComponent(4, 10);
+      buffers_.push_back(makeComponent(2, 4));
+      ff_->load(FF, buffers_.back());
+      wps_.push_back(makeComponent(1, 2));
+      buffers_.back()->load(BUFFER, wps_.back());
+      wfs_.push_back(makeComponent(0, 1));
+      wps_.back()->load(WP, wfs_.back());
+
+      sched_ = TockSchedulerPtr(new TockScheduler());
+      sched_->rebuild(wfs_, wps_, buffers_, ff_);
+      solver_ = EBSSolverPtr(new EBSSolver(1));
+    }
+    virtual void TearDown() {
+    }
+
+    ComponentPtr makeComponent(Radius r_in, Radius r_out){
+      // a component that has degraded entirely is well mixed
+      ComponentPtr comp = ComponentPtr(new Component());
+      DegRateNuclidePtr model = DegRateNuclide::create();
+      model->set_deg_rate(1);
+      comp->set_nuclide_model(model);
+      point_t origin = {0,0,0};
+      comp->nuclide_model()->set_geom(GeometryPtr(new Geometry(r_in, r_out, 
+              origin, 5)));
+      comp->nuclide_model()->set_mat_table(MDB->table("clay"));
+      return comp;
+    }
+
+    double mass(ComponentPtr comp){
+      const IsoMassMap& masses = comp->nuclide_model()->iso_masses();
+      IsoMassMap::const_iterator found = masses.find(u235_);
+      return (found == masses.end()) ? 0 : found->second;
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(EBSSolverTest, rebuild) {
+  EXPECT_TRUE(solver_->dirty());
+  EXPECT_EQ(0, solver_->n_nodes());
+  EXPECT_NO_THROW(solver_->rebuild(sched_->nodes(), sched_->parents()));
+  EXPECT_FALSE(solver_->dirty());
+  EXPECT_EQ(4, solver_->n_nodes());
+  // a parent before its daughter can't be eliminated without fill-in
+  vector<ComponentPtr> nodes(sched_->nodes().rbegin(), sched_->nodes().rend());
+  vector<int> parents(4, -1);
+  parents[1] = 0;
+  EXPECT_THROW(solver_->rebuild(nodes, parents), CycException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(EBSSolverTest, empty) {
+  solver_->rebuild(vector<ComponentPtr>(), vector<int>());
+  EXPECT_NO_THROW(solver_->solve(++time_));
+  EXPECT_EQ(0, solver_->n_factorizations());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(EBSSolverTest, conserves_mass) {
+  solver_->rebuild(sched_->nodes(), sched_->parents());
+  wfs_.front()->absorb(test_mat_);
+  for(int t=1; t<5; ++t){
+    ASSERT_NO_THROW(solver_->solve(t));
+    double total = mass(wfs_.front()) + mass(wps_.front()) + 
+      mass(buffers_.front()) + mass(ff_);
+    EXPECT_NEAR(test_size_, total, 1e-9*test_size_);
+  }
+  // the waste moves outward
+  EXPECT_GT(test_size_, mass(wfs_.front()));
+  EXPECT_GT(mass(wps_.front()), 0);
+  EXPECT_GT(mass(ff_), 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(EBSSolverTest, undegraded) {
+  // a waste form that doesn't degrade releases nothing
+  ComponentPtr wf = wfs_.front();
+  DegRateNuclidePtr model = 
+    boost::dynamic_pointer_cast<DegRateNuclide>(wf->nuclide_model());
+  model->set_deg_rate(0);
+  solver_->rebuild(sched_->nodes(), sched_->parents());
+  wf->absorb(test_mat_);
+  for(int t=1; t<5; ++t){
+    ASSERT_NO_THROW(solver_->solve(t));
+    EXPECT_FLOAT_EQ(test_size_, mass(wf));
+    EXPECT_FLOAT_EQ(0, mass(wps_.front()));
+    EXPECT_FLOAT_EQ(0, mass(ff_));
+  }
+  // until it starts to
+  model->set_deg_rate(0.1);
+  solver_->solve(5);
+  EXPECT_FLOAT_EQ(0.1, model->tot_deg());
+  EXPECT_GT(test_size_, mass(wf));
+  EXPECT_GT(mass(wps_.front()), 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(EBSSolverTest, reuses_factorization) {
+  solver_->rebuild(sched_->nodes(), sched_->parents());
+  wfs_.front()->absorb(test_mat_);
+  solver_->solve(1);
+  EXPECT_EQ(1, solver_->n_factorizations());
+  // the same step and isotopes reuse the factorization
+  solver_->solve(2);
+  solver_->solve(3);
+  EXPECT_EQ(1, solver_->n_factorizations());
+  // a longer step is factored again
+  solver_->solve(5);
+  EXPECT_EQ(2, solver_->n_factorizations());
+  // and so is a new tree
+  solver_->invalidate();
+  solver_->rebuild(sched_->nodes(), sched_->parents());
+  solver_->solve(7);
+  EXPECT_EQ(3, solver_->n_factorizations());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(EBSSolverTest, limits_outside_matrix) {
+  // a waste form that degrades over many steps changes the concentration at
+  // its boundary every step, without being refactored
+  ComponentPtr wf = wfs_.front();
+  DegRateNuclidePtr model = 
+    boost::dynamic_pointer_cast<DegRateNuclide>(wf->nuclide_model());
+  model->set_deg_rate(0.1);
+  solver_->rebuild(sched_->nodes(), sched_->parents());
+  wf->absorb(test_mat_);
+  double prev = test_size_;
+  for(int t=1; t<8; ++t){
+    ASSERT_NO_THROW(solver_->solve(t));
+    double total = mass(wf) + mass(wps_.front()) + 
+      mass(buffers_.front()) + mass(ff_);
+    EXPECT_NEAR(test_size_, total, 1e-9*test_size_);
+    EXPECT_GT(prev, mass(wf));
+    prev = mass(wf);
+  }
+  EXPECT_EQ(1, solver_->n_factorizations());
+}
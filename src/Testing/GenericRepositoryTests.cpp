@@ -87,6 +87,84 @@ GenericRepository* GenericRepositoryTest::initSrcFacility(){
       delete engine;
       return src_facility;
     }
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+string GenericRepositoryTest::componentXML(string name, string type, string sub,
+    string models){
+  if( models.empty() ){
+    models = "<thermalmodel><StubThermal/></thermalmodel>"
+      "<nuclidemodel><StubNuclide/></nuclidemodel>";
+  }
+  stringstream cs("");
+  cs << "  <component>"
+     << "    <name>" << name << "</name>" 
+     << "    <innerradius>" << innerradius_ << "</innerradius>" 
+     << "    <outerradius>" << outerradius_ << "</outerradius>" 
+     << "    <componenttype>" << type << "</componenttype>" 
+     << "    <material_data><clay/></material_data>"
+     << models
+     << sub
+     << "  </component>";
+  return cs.str();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+GenericRepository* GenericRepositoryTest::initEBSFacility(string wf_models,
+    string field){
+  // a waste form for the incommodity, in a waste package, in a buffer
+  stringstream ss("");
+  ss << "<start>"
+     << "  <x>" << x_ << "</x>"
+     << "  <y>" << y_ << "</y>"
+     << "  <z>" << z_ << "</z>"
+     << "  <dx>" << dx_ << "</dx>"
+     << "  <dy>" << dy_ << "</dy>"
+     << "  <dz>" << dz_ << "</dz>"
+     << "  <advective_velocity>" << adv_vel_ << "</advective_velocity>"
+     << "  <capacity>" << capacity_ << "</capacity>"
+     << "  <incommodity>" << in_commod_ << "</incommodity>"
+     << "  <inventorysize>" << inventory_size_ << "</inventorysize>"
+     << "  <lifetime>" << lifetime_ << "</lifetime>"
+     << "  <startOperMonth>" << start_op_mo_ << "</startOperMonth>"
+     << "  <startOperYear>" << start_op_yr_ << "</startOperYear>"
+     << field
+     << componentXML("wf", "WF", "<allowedcommod>" + in_commod_ + "</allowedcommod>",
+         wf_models)
+     << componentXML("wp", "WP", "<allowedwf>wf</allowedwf>")
+     << componentXML("buffer", "BUFFER", "")
+     << componentXML("ff", "FF", "")
+     << "</start>";
+
+  XMLParser parser(ss);
+  XMLQueryEngine* engine = new XMLQueryEngine(parser);
+  GenericRepository* repo = new GenericRepository();
+  repo->initModuleMembers(engine);
+  delete engine;
+  return repo;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+GenericRepository* GenericRepositoryTest::initHotFacility(){
+  // each package alone stays under the buffer limit, but not beside a 
+  // fresh one
+  stringstream wf_models("");
+  wf_models << "<thermalmodel><LumpedThermal>"
+            << "  <specific_power>60000</specific_power>"
+            << "  <half_life>" << DecayOperator::SECS_PER_TIMESTEP << "</half_life>"
+            << "</LumpedThermal></thermalmodel>"
+            << "<nuclidemodel><DegRateNuclide>"
+            << "  <advective_velocity>0</advective_velocity>"
+            << "  <degradation>0</degradation>"
+            << "</DegRateNuclide></nuclidemodel>";
+  stringstream field("");
+  field << "<thermal_field>"
+        << "  <conductivity>2</conductivity>"
+        << "  <diffusivity>0.001</diffusivity>"
+        << "  <ambient_temp>300</ambient_temp>"
+        << "  <cutoff>500</cutoff>"
+        << "</thermal_field>";
+  return initEBSFacility(wf_models.str(), field.str());
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 void GenericRepositoryTest::initWorld(){
   incommod_market = new TestMarket();
@@ -100,6 +178,102 @@ TEST_F(GenericRepositoryTest, initial_state) {
   EXPECT_EQ(adv_vel_, src_facility->adv_vel());
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(GenericRepositoryTest, running_totals) {
+  EXPECT_FLOAT_EQ(0, src_facility->checkInventory());
+  EXPECT_FLOAT_EQ(0, src_facility->checkStocks());
+  EXPECT_FLOAT_EQ(src_facility->scanInventory(), src_facility->checkInventory());
+  EXPECT_FLOAT_EQ(src_facility->scanStocks(), src_facility->checkStocks());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(GenericRepositoryTest, running_totals_emplaced) {
+  GenericRepository* repo = initEBSFacility();
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[92235] = 1;
+  vector<rsrc_ptr> manifest;
+  for(int i=0; i<3; ++i){
+    mat_rsrc_ptr mat = mat_rsrc_ptr(new Material(comp));
+    mat->setQuantity(10);
+    manifest.push_back(mat);
+  }
+  Transaction trans(repo, REQUEST);
+  trans.setCommod(in_commod_);
+
+  // the received waste is in the stocks
+  repo->addResource(trans, manifest);
+  EXPECT_FLOAT_EQ(30, repo->checkStocks());
+  EXPECT_FLOAT_EQ(0, repo->checkInventory());
+  EXPECT_FLOAT_EQ(repo->scanStocks(), repo->checkStocks());
+  EXPECT_FLOAT_EQ(repo->scanInventory(), repo->checkInventory());
+
+  // once it's emplaced, it is in the inventory, though the models now hold 
+  // its materials
+  repo->handleTick(0);
+  repo->handleTock(0);
+  EXPECT_FLOAT_EQ(0, repo->checkStocks());
+  EXPECT_FLOAT_EQ(30, repo->checkInventory());
+  EXPECT_FLOAT_EQ(repo->scanStocks(), repo->checkStocks());
+  EXPECT_FLOAT_EQ(repo->scanInventory(), repo->checkInventory());
+  delete repo;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(GenericRepositoryTest, hot_package_waits) {
+  // the second package waits for the first to cool, with or without more 
+  // waste arriving
+  GenericRepository* repo = initHotFacility();
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[92235] = 1;
+  vector<rsrc_ptr> manifest;
+  for(int i=0; i<2; ++i){
+    mat_rsrc_ptr mat = mat_rsrc_ptr(new Material(comp));
+    mat->setQuantity(10);
+    manifest.push_back(mat);
+  }
+  Transaction trans(repo, REQUEST);
+  trans.setCommod(in_commod_);
+  repo->addResource(trans, manifest);
+
+  repo->handleTock(0);
+  EXPECT_EQ(1, repo->n_emplaced());
+  EXPECT_EQ(1, repo->n_waiting());
+  repo->handleTock(1);
+  EXPECT_EQ(1, repo->n_emplaced());
+  EXPECT_EQ(1, repo->n_waiting());
+  repo->handleTock(6);
+  EXPECT_EQ(2, repo->n_emplaced());
+  EXPECT_EQ(0, repo->n_waiting());
+  delete repo;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(GenericRepositoryTest, clone_is_thermally_limited) {
+  // a clone of the repository has a thermal field of its own, so it holds 
+  // back a package that would be too hot beside the one it emplaced
+  GenericRepository* proto = initHotFacility();
+  GenericRepository* repo = new GenericRepository();
+  repo->cloneModuleMembersFrom(proto);
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[92235] = 1;
+  vector<rsrc_ptr> manifest;
+  for(int i=0; i<2; ++i){
+    mat_rsrc_ptr mat = mat_rsrc_ptr(new Material(comp));
+    mat->setQuantity(10);
+    manifest.push_back(mat);
+  }
+  Transaction trans(repo, REQUEST);
+  trans.setCommod(in_commod_);
+  repo->addResource(trans, manifest);
+
+  repo->handleTock(0);
+  EXPECT_EQ(1, repo->n_emplaced());
+  EXPECT_EQ(1, repo->n_waiting());
+  // and the prototype is left as it was
+  EXPECT_EQ(0, proto->n_emplaced());
+  delete repo;
+  delete proto;
+}
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 INSTANTIATE_TEST_CASE_P(GenericRepositoryFac, FacilityModelTests, Values(&GenericRepositoryFacilityConstructor));
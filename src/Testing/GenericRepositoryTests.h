@@ -19,6 +19,11 @@ protected:
   virtual void SetUp();
   virtual void TearDown();
   GenericRepository* initSrcFacility();
+  GenericRepository* initEBSFacility(std::string wf_models="", 
+      std::string field="");
+  GenericRepository* initHotFacility();
+  std::string componentXML(std::string name, std::string type, 
+      std::string sub, std::string models="");
   void initWorld();
 
 public:
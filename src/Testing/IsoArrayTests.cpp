@@ -0,0 +1,73 @@
+// IsoArrayTests.cpp
+#include <gtest/gtest.h>
+
+#include "IsoArray.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+class IsoArrayTest : public ::testing::Test {
+  protected:
+    IsoConcMap conc_;
+    Iso u235_, am241_, cs137_;
+
+    virtual void SetUp(){
+      u235_ = 92235;
+      am241_ = 95241;
+      cs137_ = 55137;
+      conc_[u235_] = 1.5;
+      conc_[am241_] = 0;
+    }
+    virtual void TearDown() {
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoArrayTest, dict) {
+  int i = IsoDict::index(u235_);
+  EXPECT_EQ(u235_, IsoDict::iso(i));
+  // the index is stable
+  EXPECT_EQ(i, IsoDict::index(u235_));
+  EXPECT_LT(i, IsoDict::size());
+  int j = IsoDict::index(cs137_);
+  EXPECT_NE(i, j);
+  EXPECT_EQ(cs137_, IsoDict::iso(j));
+  EXPECT_EQ(j, IsoDict::find(cs137_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoArrayTest, unknown) {
+  Iso unseen = 99254;
+  IsoArray arr(conc_);
+  int n_seen = IsoDict::size();
+  EXPECT_EQ(-1, IsoDict::find(unseen));
+  EXPECT_FLOAT_EQ(0, arr.at(unseen));
+  // the lookups didn't add it
+  EXPECT_EQ(-1, IsoDict::find(unseen));
+  EXPECT_EQ(n_seen, IsoDict::size());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoArrayTest, fromMap) {
+  IsoArray arr(conc_);
+  EXPECT_EQ(IsoDict::size(), arr.size());
+  EXPECT_FLOAT_EQ(1.5, arr.at(u235_));
+  EXPECT_FLOAT_EQ(0, arr.at(am241_));
+  EXPECT_FLOAT_EQ(0, arr.at(cs137_));
+  EXPECT_TRUE(arr.mask()[IsoDict::index(am241_)]);
+  // a present zero survives the round trip, an absent isotope does not
+  EXPECT_TRUE(conc_ == arr.map());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoArrayTest, resize) {
+  IsoArray arr;
+  EXPECT_EQ(0, arr.size());
+  EXPECT_TRUE(NULL == arr.vals());
+  arr.resize(4);
+  EXPECT_EQ(4, arr.size());
+  EXPECT_TRUE(arr.map().empty());
+  // arrays never shrink
+  arr.resize(2);
+  EXPECT_EQ(4, arr.size());
+}
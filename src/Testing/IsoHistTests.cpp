@@ -0,0 +1,117 @@
+// IsoHistTests.cpp
+#include <gtest/gtest.h>
+
+#include "IsoHist.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+class IsoHistTest : public ::testing::Test {
+  protected:
+    IsoHist hist_;
+    IsoConcMap conc_a_, conc_b_;
+    Iso u235_, u238_, cs137_;
+    int time_;
+
+    virtual void SetUp(){
+      u235_ = 92235;
+      u238_ = 92238;
+      cs137_ = 55137;
+      time_ = 3;
+      conc_a_[u235_] = 1.5;
+      conc_a_[u238_] = 0;
+      conc_b_[cs137_] = 2.5;
+      conc_b_[u238_] = 4;
+    }
+    virtual void TearDown() {
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, defaultConstructor) {
+  EXPECT_TRUE(hist_.empty());
+  EXPECT_FALSE(hist_.has(time_));
+  EXPECT_EQ(0, hist_.n_isos());
+  EXPECT_TRUE(NULL == hist_.row(time_));
+  EXPECT_FLOAT_EQ(0, hist_.at(time_, u235_));
+  EXPECT_FLOAT_EQ(0, hist_.mass(time_));
+  EXPECT_TRUE(hist_.map(time_).empty());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, setAndGet) {
+  hist_.set(time_, conc_a_, 10);
+  EXPECT_FALSE(hist_.empty());
+  EXPECT_TRUE(hist_.has(time_));
+  EXPECT_FALSE(hist_.has(time_+1));
+  EXPECT_FLOAT_EQ(1.5, hist_.at(time_, u235_));
+  EXPECT_FLOAT_EQ(0, hist_.at(time_, u238_));
+  EXPECT_FLOAT_EQ(10, hist_.mass(time_));
+  EXPECT_TRUE(conc_a_ == hist_.map(time_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, newColumns) {
+  hist_.set(time_, conc_a_);
+  hist_.set(time_+2, conc_b_);
+  EXPECT_EQ(3, hist_.n_isos());
+  // the columns are sorted
+  EXPECT_EQ(cs137_, hist_.isos()[0]);
+  EXPECT_EQ(0, hist_.col(cs137_));
+  EXPECT_EQ(-1, hist_.col(94239));
+  // adding a column keeps the older rows intact
+  EXPECT_TRUE(conc_a_ == hist_.map(time_));
+  EXPECT_TRUE(conc_b_ == hist_.map(time_+2));
+  // the skipped row is absent
+  EXPECT_FALSE(hist_.has(time_+1));
+  EXPECT_TRUE(hist_.map(time_+1).empty());
+  // an isotope missing from a row is absent, not zero
+  const double* row = hist_.row(time_);
+  ASSERT_FALSE(NULL == row);
+  EXPECT_TRUE(IsoHist::absent(row[hist_.col(cs137_)]));
+  EXPECT_FALSE(IsoHist::absent(row[hist_.col(u238_)]));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, earlierRows) {
+  hist_.set(time_, conc_a_);
+  hist_.set(time_-2, conc_b_);
+  EXPECT_TRUE(conc_a_ == hist_.map(time_));
+  EXPECT_TRUE(conc_b_ == hist_.map(time_-2));
+  EXPECT_FALSE(hist_.has(time_-1));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, overwrite) {
+  hist_.set(time_, conc_a_, 1);
+  hist_.set(time_, conc_b_, 2);
+  EXPECT_TRUE(conc_b_ == hist_.map(time_));
+  EXPECT_FLOAT_EQ(2, hist_.mass(time_));
+  EXPECT_FLOAT_EQ(0, hist_.at(time_, u235_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, version) {
+  unsigned long v0 = hist_.version();
+  hist_.set(time_, conc_a_);
+  unsigned long v1 = hist_.version();
+  EXPECT_NE(v0, v1);
+  hist_.map(time_);
+  hist_.at(time_, u235_);
+  EXPECT_EQ(v1, hist_.version());
+  hist_.set(time_, conc_a_);
+  EXPECT_NE(v1, hist_.version());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(IsoHistTest, vec) {
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[u235_] = 0.25;
+  (*comp)[u238_] = 0.75;
+  hist_.set(time_, make_pair(IsoVector(comp), 100.0));
+  pair<IsoVector, double> got = hist_.vec(time_);
+  EXPECT_FLOAT_EQ(100, got.second);
+  EXPECT_FLOAT_EQ(0.25, (*got.first.comp())[u235_]);
+  EXPECT_FLOAT_EQ(0.75, (*got.first.comp())[u238_]);
+  EXPECT_FLOAT_EQ(0, hist_.vec(time_+1).second);
+}
@@ -0,0 +1,113 @@
+// LumpedThermalTests.cpp
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "LumpedThermal.h"
+#include "CycException.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class LumpedThermalTest : public ::testing::Test {
+  protected:
+    ThermalModelPtr model_;
+    Temp lim_;
+
+    virtual void SetUp(){
+      lim_ = 350;
+      model_ = LumpedThermal::create();
+      model_->set_temp_lim(lim_);
+    }
+    virtual void TearDown() {
+    }
+    void record(int the_time, Temp temp){
+      model_->set_temp(temp);
+      model_->transportHeat(the_time);
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(LumpedThermalTest, peak_temp) {
+  EXPECT_FLOAT_EQ(0, model_->peak_temp());
+  EXPECT_TRUE(model_->temp_hist().empty());
+  // the peak is the hottest temperature, not the latest time
+  record(0, 300);
+  record(1, 340);
+  record(2, 320);
+  EXPECT_FLOAT_EQ(340, model_->peak_temp());
+  EXPECT_EQ(1, model_->peak_time());
+  EXPECT_FLOAT_EQ(320, model_->temp());
+  EXPECT_EQ(3, model_->temp_hist().size());
+  // a tie keeps the first time it was reached
+  record(3, 340);
+  EXPECT_EQ(1, model_->peak_time());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(LumpedThermalTest, exceedance) {
+  EXPECT_FLOAT_EQ(lim_, model_->temp_lim());
+  record(0, 300);
+  EXPECT_EQ(0, model_->exceedance());
+  record(1, 360);
+  record(2, 370);
+  EXPECT_EQ(2, model_->exceedance());
+  // each record counts the time since the one before it
+  record(6, 355);
+  EXPECT_EQ(6, model_->exceedance());
+  record(7, lim_);
+  record(8, 300);
+  EXPECT_EQ(6, model_->exceedance());
+  EXPECT_EQ(2, model_->peak_time());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(LumpedThermalTest, hist_limit) {
+  EXPECT_EQ(0, model_->hist_limit());
+  EXPECT_THROW(model_->set_hist_limit(-1), CycRangeException);
+  EXPECT_THROW(model_->set_hist_limit(1), CycRangeException);
+  EXPECT_NO_THROW(model_->set_hist_limit(16));
+  int n_steps = 12000;
+  for(int t=0; t < n_steps; ++t){
+    record(t, 350 - 0.01*abs(t - 4321));
+  }
+  // the history is bounded, and still covers the whole simulation
+  const TempHist& hist = model_->temp_hist();
+  EXPECT_LE(hist.size(), 16);
+  EXPECT_GE(hist.size(), 8);
+  EXPECT_EQ(0, hist.begin()->first);
+  EXPECT_GT(hist.rbegin()->first, n_steps/2);
+  // but the peak is exact
+  EXPECT_NEAR(350, model_->peak_temp(), 1e-6);
+  EXPECT_EQ(4321, model_->peak_time());
+  // limiting a history that is already longer decimates it
+  ThermalModelPtr whole = LumpedThermal::create();
+  for(int t=0; t < 100; ++t){
+    whole->set_temp(t);
+    whole->transportHeat(t);
+  }
+  EXPECT_EQ(100, whole->temp_hist().size());
+  whole->set_hist_limit(10);
+  EXPECT_LE(whole->temp_hist().size(), 10);
+  EXPECT_FLOAT_EQ(99, whole->peak_temp());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(LumpedThermalTest, copy) {
+  LumpedThermalPtr src = boost::dynamic_pointer_cast<LumpedThermal>(model_);
+  src->set_specific_power(2);
+  src->set_half_life(100);
+  src->set_hist_limit(8);
+  record(0, 400);
+  ThermalModelPtr dest = LumpedThermal::create();
+  dest->copy(model_);
+  LumpedThermalPtr copied = boost::dynamic_pointer_cast<LumpedThermal>(dest);
+  EXPECT_FLOAT_EQ(2, copied->specific_power());
+  EXPECT_FLOAT_EQ(log(2.0)/100, copied->decay_const());
+  EXPECT_EQ(8, dest->hist_limit());
+  EXPECT_FLOAT_EQ(lim_, dest->temp_lim());
+  // the records are not copied
+  EXPECT_TRUE(dest->temp_hist().empty());
+  EXPECT_EQ(0, dest->exceedance());
+  EXPECT_THROW(src->set_specific_power(-1), CycRangeException);
+  EXPECT_THROW(src->set_half_life(-1), CycRangeException);
+}
@@ -66,11 +66,74 @@ TEST_F(MatToolsTest, sum_mats_one){
   EXPECT_FLOAT_EQ(1, the_sum.first.comp()->atomFraction(u235_));
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, sum_mats_weights){
+  // each material is weighted by its own mass
+  CompMapPtr am_comp = CompMapPtr(new CompMap(MASS));
+  (*am_comp)[am241_] = 1;
+  mat_rsrc_ptr am_mat = mat_rsrc_ptr(new Material(am_comp));
+  am_mat->setQuantity(3*test_size_);
+
+  deque<mat_rsrc_ptr> mats;
+  mats.push_back(test_mat_);
+  mats.push_back(am_mat);
+  pair<IsoVector, double> the_sum = MatTools::sum_mats(mats);
+  EXPECT_FLOAT_EQ(4*test_size_, the_sum.second);
+  EXPECT_FLOAT_EQ(0.25, the_sum.first.comp()->massFraction(u235_));
+  EXPECT_FLOAT_EQ(0.75, the_sum.first.comp()->massFraction(am241_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, add_masses){
+  IsoMassMap masses;
+  EXPECT_FLOAT_EQ(test_size_, MatTools::add_masses(test_mat_, masses));
+  EXPECT_FLOAT_EQ(test_size_, masses[u235_]);
+  EXPECT_FLOAT_EQ(2*test_size_, MatTools::add_masses(test_mat_, masses, 2));
+  EXPECT_FLOAT_EQ(3*test_size_, masses[u235_]);
+  EXPECT_FLOAT_EQ(-test_size_, MatTools::add_masses(test_mat_, masses, -1));
+  EXPECT_FLOAT_EQ(2*test_size_, masses[u235_]);
+  // nothing is left with a negative mass
+  MatTools::add_masses(test_mat_, masses, -5);
+  EXPECT_FLOAT_EQ(0, masses[u235_]);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(MatToolsTest, extract){
   //@TODO this is just a placeholder, to remind you to write a test.
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, extract_masses){
+  IsoMassMap masses;
+  masses[u235_] = 2*test_size_;
+  masses[am241_] = 2*test_size_;
+
+  // a composition is taken in proportion
+  CompMapPtr comp = CompMapPtr(new CompMap(MASS));
+  (*comp)[u235_] = 1;
+  (*comp)[am241_] = 1;
+  mat_rsrc_ptr got;
+  EXPECT_NO_THROW(got = MatTools::extract(comp, test_size_, masses));
+  EXPECT_FLOAT_EQ(test_size_, got->mass(MassUnit(KG)));
+  EXPECT_FLOAT_EQ(1.5*test_size_, masses[u235_]);
+  EXPECT_FLOAT_EQ(1.5*test_size_, masses[am241_]);
+
+  // several isotopes at once
+  IsoMassMap kgs;
+  kgs[u235_] = test_size_;
+  kgs[am241_] = 0.5*test_size_;
+  EXPECT_NO_THROW(got = MatTools::extract(kgs, masses));
+  EXPECT_FLOAT_EQ(1.5*test_size_, got->mass(MassUnit(KG)));
+  EXPECT_FLOAT_EQ(0.5*test_size_, masses[u235_]);
+  EXPECT_FLOAT_EQ(test_size_, masses[am241_]);
+
+  // too much of one isotope takes nothing
+  kgs[u235_] = test_size_;
+  EXPECT_THROW(MatTools::extract(kgs, masses), CycRangeException);
+  EXPECT_FLOAT_EQ(0.5*test_size_, masses[u235_]);
+  EXPECT_FLOAT_EQ(test_size_, masses[am241_]);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(MatToolsTest, convert_comp_to_conc){ 
   IsoConcMap test_conc_map; 
@@ -210,3 +273,93 @@ TEST_F(MatToolsTest, V_ms){
 }
 
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, scaleConcMap){ 
+  IsoConcMap C_0;
+  C_0[u235_] = 2;
+  C_0[am241_] = 0.5;
+  IsoConcMap scaled = MatTools::scaleConcMap(C_0, 3);
+  EXPECT_EQ(2, scaled.size());
+  EXPECT_FLOAT_EQ(6, scaled[u235_]);
+  EXPECT_FLOAT_EQ(1.5, scaled[am241_]);
+  // the original is untouched
+  EXPECT_FLOAT_EQ(2, C_0[u235_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, dense_kernels){ 
+  int n = 3;
+  double c_ext[] = {1, 2, 0};
+  double c_int[] = {3, 0, 4};
+  double D[] = {2, 2, 1};
+  double grad[3], q[3];
+  char a[] = {1, 1, 0};
+  char b[] = {1, 0, 1};
+  char mask[3];
+
+  MatTools::conc_grad(c_ext, c_int, 0.5, 2, grad, n);
+  EXPECT_FLOAT_EQ((1-1.5)/2, grad[0]);
+  EXPECT_FLOAT_EQ(1, grad[1]);
+  EXPECT_FLOAT_EQ(-1, grad[2]);
+
+  MatTools::flux(D, grad, c_ext, 10, q, n);
+  EXPECT_FLOAT_EQ(-2*grad[0] + 10, q[0]);
+  EXPECT_FLOAT_EQ(-2*grad[1] + 20, q[1]);
+  EXPECT_FLOAT_EQ(1, q[2]);
+
+  MatTools::scale(c_int, 2, n);
+  EXPECT_FLOAT_EQ(6, c_int[0]);
+  EXPECT_FLOAT_EQ(8, c_int[2]);
+
+  MatTools::mask_or(a, b, mask, n);
+  EXPECT_TRUE(mask[0] && mask[1] && mask[2]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, gather){ 
+  IsoConcMap a, b;
+  a[92235] = 1;
+  a[95241] = 2;
+  b[55137] = 3;
+  b[92235] = 4;
+  vector<int> isos = MatTools::iso_union(a, b);
+  ASSERT_EQ(3, isos.size());
+  EXPECT_EQ(55137, isos[0]);
+  EXPECT_EQ(92235, isos[1]);
+  EXPECT_EQ(95241, isos[2]);
+
+  double vals[3];
+  MatTools::gather(a, isos, vals);
+  EXPECT_FLOAT_EQ(0, vals[0]);
+  EXPECT_FLOAT_EQ(1, vals[1]);
+  EXPECT_FLOAT_EQ(2, vals[2]);
+  MatTools::gather(b, isos, vals);
+  EXPECT_FLOAT_EQ(3, vals[0]);
+  EXPECT_FLOAT_EQ(4, vals[1]);
+  EXPECT_FLOAT_EQ(0, vals[2]);
+  EXPECT_TRUE(MatTools::iso_union(IsoConcMap(), IsoConcMap()).empty());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MatToolsTest, tridiag){ 
+  // two systems of three rows, interleaved by row
+  int n_rows = 3;
+  int n_sys = 2;
+  double lower[] = {0, 0, -1, 0, -1, 0};
+  double diag[] = {2, 4, 2, 4, 2, 4};
+  double upper[] = {-1, 0, -1, 0, 0, 0};
+  double x[] = {1, 4, 0, 8, 1, 12};
+  double work[6];
+
+  MatTools::tridiag(lower, diag, upper, x, work, n_rows, n_sys);
+  // the first is the discrete laplacian, the second is diagonal
+  EXPECT_FLOAT_EQ(1, x[0]);
+  EXPECT_FLOAT_EQ(1, x[2]);
+  EXPECT_FLOAT_EQ(1, x[4]);
+  EXPECT_FLOAT_EQ(1, x[1]);
+  EXPECT_FLOAT_EQ(2, x[3]);
+  EXPECT_FLOAT_EQ(3, x[5]);
+  // the coefficients are untouched
+  EXPECT_FLOAT_EQ(2, diag[2]);
+}
@@ -1,6 +1,35 @@
 // MaterialDBTests.cpp
 #include <gtest/gtest.h>
 #include "MaterialDBTests.h"
+#include "CycException.h"
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+namespace fs = boost::filesystem;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+/// writes a small material database to a fresh temporary file
+std::string makeTestDB(){
+  std::string path = (fs::temp_directory_path() / 
+      fs::unique_path("cyder-%%%%-%%%%.sqlite")).string();
+  SqliteDb db(path);
+  db.execute("CREATE TABLE clay (elem INTEGER, d REAL, k_d REAL, s REAL)");
+  db.execute("INSERT INTO clay VALUES (92, 1.0, 2.0, 3.0)");
+  db.execute("INSERT INTO clay VALUES (82, 4.0, 5.0, 6.0)");
+  db.execute("CREATE TABLE salt (elem INTEGER, d REAL, k_d REAL, s REAL)");
+  db.execute("INSERT INTO salt VALUES (90, 7.0, 8.0, 9.0)");
+  db.execute("CREATE TABLE notes (text TEXT)");
+  return path;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+/// removes a test database and its snapshot
+void removeTestDB(std::string path){
+  fs::remove(path);
+  fs::remove(MaterialDB::snapshotPath(path, MaterialDB::cacheDir()));
+}
 
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
@@ -102,3 +131,148 @@ TEST_F(MaterialDBTest, infSolLimits){
 }
 
 
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, table_by_elem){
+  // rows are looked up by element number, whatever order they come in
+  std::vector<element_t> rows;
+  element_t u = {u_, 1, 2, 3};
+  element_t pb = {pb_, 4, 5, 6};
+  rows.push_back(u);
+  rows.push_back(pb);
+  MatDataTable table("test", rows);
+  EXPECT_FLOAT_EQ(1, table.D(u_));
+  EXPECT_FLOAT_EQ(2, table.K_d(u_));
+  EXPECT_FLOAT_EQ(3, table.S(u_));
+  EXPECT_FLOAT_EQ(4, table.data(pb_, DISP));
+  EXPECT_FLOAT_EQ(5, table.data(pb_, KD));
+  EXPECT_FLOAT_EQ(6, table.data(pb_, SOL));
+  EXPECT_TRUE(table.valid(u_));
+  EXPECT_EQ(u_, table.max_elem());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, table_invalid_elem){
+  // elements missing from the table, or outside of it, are not valid
+  std::vector<element_t> rows;
+  element_t u = {u_, 1, 2, 3};
+  rows.push_back(u);
+  MatDataTable table("test", rows);
+  EXPECT_FALSE(table.valid(th_));
+  EXPECT_FALSE(table.valid(am_));
+  EXPECT_FALSE(table.valid(-1));
+  EXPECT_THROW(table.K_d(th_), CycException);
+  EXPECT_THROW(table.S(am_), CycException);
+  EXPECT_THROW(table.D(-1), CycException);
+  EXPECT_THROW(MatDataTable().D(u_), CycException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, preload){
+  // every material table is loaded up front, and other tables are skipped
+  std::string path = makeTestDB();
+  MaterialDB mdb(path);
+  EXPECT_EQ(2, mdb.tables().size());
+  EXPECT_EQ(0, mdb.tables().count("notes"));
+  EXPECT_FLOAT_EQ(2, mdb.K_d("clay", u_));
+  EXPECT_FLOAT_EQ(6, mdb.S("clay", pb_));
+  EXPECT_FLOAT_EQ(7, mdb.D("salt", th_));
+  EXPECT_THROW(mdb.table("notes"), CycException);
+  EXPECT_THROW(mdb.K_d("granite", u_), CycException);
+  removeTestDB(path);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, snapshot){
+  // a later run reads the snapshot, and gets the same tables
+  std::string path = makeTestDB();
+  {
+    MaterialDB mdb(path);
+    EXPECT_TRUE(fs::exists(mdb.snapshot_path()));
+  }
+  MaterialDB mdb(path);
+  EXPECT_EQ(2, mdb.tables().size());
+  EXPECT_FLOAT_EQ(1, mdb.D("clay", u_));
+  EXPECT_FLOAT_EQ(5, mdb.K_d("clay", pb_));
+  EXPECT_FLOAT_EQ(9, mdb.S("salt", th_));
+  removeTestDB(path);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, snapshot_dir){
+  // the snapshot isn't written beside the database, which may be read-only
+  std::string path = makeTestDB();
+  {
+    MaterialDB mdb(path);
+    EXPECT_FALSE(fs::exists(path + ".snapshot"));
+    EXPECT_NE(fs::path(path).parent_path(), 
+        fs::path(mdb.snapshot_path()).parent_path());
+  }
+  // and it goes where it's asked to, making the directory if need be
+  fs::path dir = fs::temp_directory_path() / 
+    fs::unique_path("cyder-cache-%%%%-%%%%");
+  {
+    MaterialDB mdb(path, dir.string());
+    EXPECT_EQ(dir, fs::path(mdb.snapshot_path()).parent_path());
+    EXPECT_TRUE(fs::exists(mdb.snapshot_path()));
+  }
+  MaterialDB mdb(path, dir.string());
+  EXPECT_FLOAT_EQ(5, mdb.K_d("clay", pb_));
+  fs::remove_all(dir);
+  removeTestDB(path);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, stale_snapshot){
+  // a snapshot is not used once the database has changed, or if it's junk
+  std::string path = makeTestDB();
+  std::string snapshot;
+  {
+    MaterialDB mdb(path);
+    snapshot = mdb.snapshot_path();
+  }
+  {
+    SqliteDb db(path);
+    db.execute("UPDATE clay SET k_d=20.0 WHERE elem=92");
+  }
+  {
+    MaterialDB mdb(path);
+    EXPECT_FLOAT_EQ(20, mdb.K_d("clay", u_));
+  }
+  {
+    std::ofstream junk(snapshot.c_str(), std::ios::trunc);
+    junk << "not a snapshot";
+  }
+  MaterialDB mdb(path);
+  EXPECT_FLOAT_EQ(20, mdb.K_d("clay", u_));
+  EXPECT_FLOAT_EQ(7, mdb.D("salt", th_));
+  removeTestDB(path);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+/// looks up the same data many times, counting the lookups that are wrong
+void lookupMany(const MaterialDB* mdb, int* n_wrong){
+  for(int i=0; i < 10000; ++i){
+    if( mdb->K_d("clay", 92) != 2 || mdb->table("salt")->D(90) != 7 ){
+      ++(*n_wrong);
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(MaterialDBTest, concurrent_lookups){
+  // once loaded, lookups from many threads need no lock
+  std::string path = makeTestDB();
+  MaterialDB mdb(path);
+  int n_threads = 8;
+  std::vector<int> n_wrong(n_threads, 0);
+  boost::thread_group threads;
+  for(int t=0; t < n_threads; ++t){
+    threads.create_thread(boost::bind(&lookupMany, &mdb, &n_wrong[t]));
+  }
+  threads.join_all();
+  for(int t=0; t < n_threads; ++t){
+    EXPECT_EQ(0, n_wrong[t]);
+  }
+  removeTestDB(path);
+}
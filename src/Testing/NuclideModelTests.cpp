@@ -96,3 +96,19 @@ TEST_P(NuclideModelTests, crude_neumann){
   EXPECT_NO_THROW(nuclide_model_->set_geom(geom_));
   EXPECT_FLOAT_EQ(0, nuclide_model_->neumann_bc(zeromap,r_five_+10,u235_));
 }
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+TEST_P(NuclideModelTests, batched_bcs){
+  // the per-isotope bcs read the batched ones, which are evaluated once
+  IsoConcMap zeromap;
+  zeromap.insert(std::make_pair(92235,0));
+  EXPECT_NO_THROW(nuclide_model_->set_geom(geom_));
+  const IsoConcMap& dirichlet = nuclide_model_->dirichlet_bcs();
+  EXPECT_EQ(&dirichlet, &nuclide_model_->dirichlet_bcs());
+  EXPECT_FLOAT_EQ(dirichlet.count(u235_) ? dirichlet.find(u235_)->second : 0,
+      nuclide_model_->dirichlet_bc(u235_));
+  IsoFluxMap cauchy = nuclide_model_->cauchy_bcs(zeromap, r_five_+10);
+  EXPECT_TRUE(cauchy == nuclide_model_->cauchy_bcs(zeromap, r_five_+10));
+  EXPECT_TRUE(cauchy == nuclide_model_->cauchy_bc(zeromap, r_five_+10));
+  ConcGradMap neumann = nuclide_model_->neumann_bcs(zeromap, r_five_+10);
+  EXPECT_TRUE(neumann == nuclide_model_->neumann_bc(zeromap, r_five_+10));
+}
@@ -63,7 +63,7 @@ void OneDimPPMNuclideTest::TearDown() {
 double OneDimPPMNuclideTest::calculate_conc(IsoConcMap C_0, double r, Iso iso, int dt) {
   double D_L = mat_table_->D(iso/1000);
   double pi = boost::math::constants::pi<double>();
-  double term_1_frac = (r-v_*dt)/2*pow(D_L*dt,0.5);
+  double term_1_frac = (r-v_*dt)/(2*pow(D_L*dt,0.5));
   double term_1_scalar = boost::math::erfc(term_1_frac);
   double term_2_radical = (pow(v_,2)*dt/pi/D_L);
   double term_2_exp = exp( -pow(r-v_*dt,2)/(4*D_L*dt)); 
@@ -196,6 +196,45 @@ TEST_F(OneDimPPMNuclideTest, set_porosity){
   EXPECT_NE(one_dim_ppm_ptr_->porosity(), porosity_);
 }
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(OneDimPPMNuclideTest, conc_profile){ 
+  // the batched profile matches the analytic solution, point by point
+  EXPECT_NO_THROW(one_dim_ppm_ptr_->set_geom(geom_));
+  IsoConcMap C_0;
+  C_0[u235_] = 1;
+  C_0[92238] = 2;
+  C_0[am241_] = 3;
+  int dt = 10;
+
+  vector<Radius> radii = one_dim_ppm_ptr_->profile_radii(5);
+  ASSERT_EQ(5, radii.size());
+  EXPECT_FLOAT_EQ(r_four_ + 0.1, radii.front());
+  EXPECT_FLOAT_EQ(r_five_ - 0.1, radii.back());
+
+  vector<IsoConcMap> profile;
+  EXPECT_NO_THROW(profile = one_dim_ppm_ptr_->conc_profile(C_0, radii, dt));
+  ASSERT_EQ(radii.size(), profile.size());
+  for(size_t k=0; k < radii.size(); ++k){
+    ASSERT_EQ(C_0.size(), profile[k].size());
+    IsoConcMap::iterator it;
+    for(it=C_0.begin(); it!=C_0.end(); ++it){
+      double expected = calculate_conc(C_0, radii[k], (*it).first, dt);
+      EXPECT_NEAR(expected, profile[k][(*it).first], 1e-9*fabs(expected));
+      EXPECT_NEAR(expected, 
+          one_dim_ppm_ptr_->calculate_conc(C_0, radii[k], (*it).first, dt), 
+          1e-9*fabs(expected));
+    }
+  }
+
+  // the single radius is the same as a profile of one
+  IsoConcMap at_mid = one_dim_ppm_ptr_->conc_profile(C_0, radii[2], dt);
+  EXPECT_FLOAT_EQ(profile[2][am241_], at_mid[am241_]);
+
+  // with no time passed, nothing has moved
+  IsoConcMap unmoved = one_dim_ppm_ptr_->conc_profile(C_0, radii[2], 0);
+  EXPECT_FLOAT_EQ(C_0[92238], unmoved[92238]);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
 TEST_F(OneDimPPMNuclideTest, transportNuclidesZero){ 
   // for some settings, nothing should be released
@@ -0,0 +1,73 @@
+// PoolAllocTests.cpp
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "PoolAlloc.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class Pooled : public PoolAlloc<Pooled> {
+  public:
+    Pooled(int val) : val_(val) {++n_live_;};
+    virtual ~Pooled() {--n_live_;};
+    int val_;
+    double pad_[3];
+    static int n_live_;
+};
+int Pooled::n_live_ = 0;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class BiggerPooled : public Pooled {
+  public:
+    BiggerPooled(int val) : Pooled(val) {};
+    double more_[8];
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PoolAllocTest, new_delete) {
+  vector<Pooled*> objs;
+  for(int i=0; i < 1000; ++i){
+    objs.push_back(new Pooled(i));
+  }
+  EXPECT_EQ(1000, Pooled::n_live_);
+  for(int i=0; i < 1000; ++i){
+    EXPECT_EQ(i, objs[i]->val_);
+  }
+  // the memory of deleted objects is reused
+  Pooled* freed = objs.back();
+  delete freed;
+  objs.pop_back();
+  Pooled* reused = new Pooled(-1);
+  EXPECT_EQ(freed, reused);
+  objs.push_back(reused);
+  for(size_t i=0; i < objs.size(); ++i){
+    delete objs[i];
+  }
+  EXPECT_EQ(0, Pooled::n_live_);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PoolAllocTest, derived) {
+  // a larger derived class is allocated from the heap, and deleted there
+  Pooled* bigger = new BiggerPooled(7);
+  EXPECT_EQ(7, bigger->val_);
+  EXPECT_NO_THROW(delete bigger);
+  EXPECT_EQ(0, Pooled::n_live_);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST(PoolAllocTest, share) {
+  {
+    boost::shared_ptr<Pooled> shared = Pooled::share(new Pooled(3));
+    boost::shared_ptr<Pooled> other = shared;
+    EXPECT_EQ(2, shared.use_count());
+    EXPECT_EQ(3, other->val_);
+    EXPECT_EQ(1, Pooled::n_live_);
+  }
+  EXPECT_EQ(0, Pooled::n_live_);
+  boost::shared_ptr<Pooled> bigger = Pooled::share<Pooled>(new BiggerPooled(4));
+  EXPECT_EQ(4, bigger->val_);
+  bigger.reset();
+  EXPECT_EQ(0, Pooled::n_live_);
+}
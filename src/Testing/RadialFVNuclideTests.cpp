@@ -0,0 +1,252 @@
+// RadialFVNuclideTests.cpp
+#include <deque>
+#include <map>
+#include <gtest/gtest.h>
+
+#include "RadialFVNuclideTests.h"
+#include "NuclideModelTests.h"
+#include "NuclideModel.h"
+#include "CycException.h"
+#include "Material.h"
+#include "XMLQueryEngine.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclideTest::SetUp(){
+  // set up geometry. this usually happens in the component init
+  r_four_ = 4;
+  r_five_ = 5;
+  point_t origin_ = {0,0,0}; 
+  len_five_ = 5;
+  geom_ = GeometryPtr(new Geometry(r_four_, r_five_, origin_, len_five_));
+
+  // other vars
+  v_ = 1; // m/yr
+  time_ = 0;
+  n_cells_ = 10;
+  porosity_ = 0.1;
+  rho_ = 1.5;
+
+  // composition set up
+  u235_=92235;
+  one_kg_=1.0;
+  test_comp_= CompMapPtr(new CompMap(MASS));
+  (*test_comp_)[u235_] = one_kg_;
+  test_size_=10.0;
+
+  // material creation
+  test_mat_ = mat_rsrc_ptr(new Material(test_comp_));
+  test_mat_->setQuantity(test_size_);
+
+  // test_radial_fv_nuclide model setup
+  mat_table_ = MDB->table("clay");
+  radial_fv_ptr_ = RadialFVNuclidePtr(initNuclideModel());
+  radial_fv_ptr_->set_mat_table(mat_table_);
+  radial_fv_ptr_->set_geom(geom_);
+  nuc_model_ptr_ = boost::dynamic_pointer_cast<NuclideModel>(radial_fv_ptr_);
+  default_radial_fv_ptr_ = RadialFVNuclidePtr(RadialFVNuclide::create());
+  default_nuc_model_ptr_ = boost::dynamic_pointer_cast<NuclideModel>(default_radial_fv_ptr_);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+void RadialFVNuclideTest::TearDown() {
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+NuclideModelPtr RadialFVNuclideModelConstructor (){
+  return boost::dynamic_pointer_cast<NuclideModel>(RadialFVNuclide::create());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+RadialFVNuclidePtr RadialFVNuclideTest::initNuclideModel(){
+  stringstream ss("");
+  ss << "<start>"
+     << "  <advective_velocity>" << v_ << "</advective_velocity>"
+     << "  <porosity>" << porosity_ << "</porosity>"
+     << "  <bulk_density>" << rho_ << "</bulk_density>"
+     << "  <cells>" << n_cells_ << "</cells>"
+     << "</start>";
+
+  XMLParser parser(ss);
+  XMLQueryEngine* engine = new XMLQueryEngine(parser);
+  RadialFVNuclidePtr radial_fv_ptr = RadialFVNuclidePtr(RadialFVNuclide::create(engine));
+  delete engine;
+  return radial_fv_ptr;  
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+double RadialFVNuclideTest::cells_mass(){
+  double to_ret = 0;
+  for(int i=0; i < radial_fv_ptr_->n_cells(); ++i){
+    IsoMassMap masses = radial_fv_ptr_->cell_masses(i);
+    IsoMassMap::iterator it;
+    for(it=masses.begin(); it!=masses.end(); ++it){
+      to_ret += (*it).second;
+    }
+  }
+  return to_ret;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, initial_state) {
+  EXPECT_EQ(v_, radial_fv_ptr_->v());
+  EXPECT_EQ(porosity_, radial_fv_ptr_->porosity());
+  EXPECT_EQ(rho_, radial_fv_ptr_->rho());
+  EXPECT_EQ(n_cells_, radial_fv_ptr_->n_cells());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, defaultConstructor) {
+  ASSERT_EQ("RADIALFV_NUCLIDE", default_nuc_model_ptr_->name());
+  ASSERT_EQ(RADIALFV_NUCLIDE, default_nuc_model_ptr_->type());
+  ASSERT_EQ(1, default_radial_fv_ptr_->n_cells());
+  ASSERT_FLOAT_EQ(0, default_radial_fv_ptr_->porosity());
+  ASSERT_FLOAT_EQ(0, default_radial_fv_ptr_->geom()->length());
+  ASSERT_FLOAT_EQ(0, default_radial_fv_ptr_->contained_mass(0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, copy) {
+  RadialFVNuclidePtr test_copy = RadialFVNuclidePtr(RadialFVNuclide::create());
+  EXPECT_NO_THROW(test_copy->copy(*nuc_model_ptr_));
+  EXPECT_FLOAT_EQ(v_, test_copy->v());
+  EXPECT_FLOAT_EQ(porosity_, test_copy->porosity());
+  EXPECT_FLOAT_EQ(rho_, test_copy->rho());
+  EXPECT_EQ(n_cells_, test_copy->n_cells());
+  EXPECT_FLOAT_EQ(0, test_copy->contained_mass(0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, shared_params) {
+  // setting the parameters of a copy leaves the template and the other 
+  // copies as they were
+  RadialFVNuclidePtr first = RadialFVNuclide::create();
+  RadialFVNuclidePtr second = RadialFVNuclide::create();
+  first->copy(*nuc_model_ptr_);
+  second->copy(*nuc_model_ptr_);
+  first->set_n_cells(n_cells_ + 2);
+  first->set_porosity(porosity_/2);
+  EXPECT_EQ(n_cells_ + 2, first->n_cells());
+  EXPECT_EQ(n_cells_, second->n_cells());
+  EXPECT_EQ(n_cells_, radial_fv_ptr_->n_cells());
+  EXPECT_FLOAT_EQ(porosity_, second->porosity());
+  EXPECT_FLOAT_EQ(rho_, first->rho());
+  // and each copy keeps its own cells
+  EXPECT_NO_THROW(first->cell_masses(n_cells_ + 1));
+  EXPECT_THROW(second->cell_masses(n_cells_ + 1), CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, set_porosity){ 
+  porosity_=0;
+  ASSERT_NO_THROW(radial_fv_ptr_->set_porosity(porosity_));
+  EXPECT_FLOAT_EQ(porosity_, radial_fv_ptr_->porosity());
+  porosity_=1;
+  ASSERT_NO_THROW(radial_fv_ptr_->set_porosity(porosity_));
+  EXPECT_FLOAT_EQ(porosity_, radial_fv_ptr_->porosity());
+  // an exception should be thrown if it's set outside the bounds
+  porosity_= -1;
+  EXPECT_THROW(radial_fv_ptr_->set_porosity(porosity_), CycRangeException);
+  EXPECT_NE(porosity_, radial_fv_ptr_->porosity());
+  porosity_= 2;
+  EXPECT_THROW(radial_fv_ptr_->set_porosity(porosity_), CycRangeException);
+  EXPECT_NE(porosity_, radial_fv_ptr_->porosity());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, set_n_cells){ 
+  EXPECT_THROW(radial_fv_ptr_->set_n_cells(0), CycRangeException);
+  EXPECT_EQ(n_cells_, radial_fv_ptr_->n_cells());
+  EXPECT_THROW(radial_fv_ptr_->cell_masses(n_cells_), CycRangeException);
+  EXPECT_THROW(radial_fv_ptr_->cell_conc(-1), CycRangeException);
+
+  // the contained mass ends up in the innermost cell
+  ASSERT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  ASSERT_NO_THROW(radial_fv_ptr_->transportNuclides(++time_));
+  ASSERT_NO_THROW(radial_fv_ptr_->set_n_cells(3));
+  EXPECT_EQ(3, radial_fv_ptr_->n_cells());
+  EXPECT_FLOAT_EQ(test_size_, radial_fv_ptr_->cell_masses(0)[u235_]);
+  EXPECT_FLOAT_EQ(0, radial_fv_ptr_->cell_masses(2)[u235_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, absorb){
+  // absorbed material goes into the innermost cell
+  for(int i=0; i<4; i++){
+    ASSERT_EQ(i,time_);
+    EXPECT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+    EXPECT_NO_THROW(radial_fv_ptr_->update(time_));
+    EXPECT_FLOAT_EQ((1+time_)*test_size_, nuc_model_ptr_->contained_mass(time_));
+    EXPECT_FLOAT_EQ((1+time_)*test_size_, radial_fv_ptr_->cell_masses(0)[u235_]);
+    time_++;
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, decay){
+  // the cells decay with the contents, and the daughter is spread like them
+  Iso th231 = 90231;
+  DecayOperator decay;
+  decay.addLink(u235_, DecayOperator::SECS_PER_TIMESTEP, th231, 1);
+  ASSERT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_NO_THROW(nuc_model_ptr_->decay(decay, 1));
+  EXPECT_FLOAT_EQ(test_size_/2, radial_fv_ptr_->iso_masses().find(u235_)->second);
+  EXPECT_FLOAT_EQ(test_size_/2, radial_fv_ptr_->cell_masses(0)[u235_]);
+  EXPECT_FLOAT_EQ(test_size_/2, radial_fv_ptr_->cell_masses(0)[th231]);
+  EXPECT_FLOAT_EQ(test_size_, cells_mass());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, transportNuclides){ 
+  ASSERT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  ASSERT_NO_THROW(nuc_model_ptr_->transportNuclides(++time_));
+
+  // the mass is conserved, and has spread out across the cells
+  EXPECT_FLOAT_EQ(test_size_, cells_mass());
+  EXPECT_FLOAT_EQ(test_size_, radial_fv_ptr_->contained_mass(time_));
+  EXPECT_GT(test_size_, radial_fv_ptr_->cell_masses(0)[u235_]);
+  for(int i=0; i < n_cells_; ++i){
+    EXPECT_GT(radial_fv_ptr_->cell_masses(i)[u235_], 0);
+  }
+
+  // the boundary concentration is the concentration in the outermost cell
+  double outer_conc = radial_fv_ptr_->cell_conc(n_cells_-1)[u235_];
+  EXPECT_GT(outer_conc, 0);
+  EXPECT_FLOAT_EQ(outer_conc, nuc_model_ptr_->dirichlet_bc(u235_));
+  IsoConcMap zero_conc_map;
+  zero_conc_map[u235_] = 0;
+  Radius r_ext = 2*r_five_;
+  double expected_neumann = -outer_conc/(r_ext - radial_fv_ptr_->cell_midpoint(n_cells_-1));
+  EXPECT_FLOAT_EQ(expected_neumann, nuc_model_ptr_->neumann_bc(zero_conc_map, r_ext, u235_));
+
+  // a longer step moves more of it outward
+  double outer_mass = radial_fv_ptr_->cell_masses(n_cells_-1)[u235_];
+  time_ += 10;
+  ASSERT_NO_THROW(nuc_model_ptr_->transportNuclides(time_));
+  EXPECT_FLOAT_EQ(test_size_, cells_mass());
+  EXPECT_GT(radial_fv_ptr_->cell_masses(n_cells_-1)[u235_], outer_mass);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(RadialFVNuclideTest, source_term_bc){ 
+  ASSERT_NO_THROW(nuc_model_ptr_->absorb(test_mat_));
+  EXPECT_FLOAT_EQ(0, nuc_model_ptr_->source_term_bc().second);
+  ASSERT_NO_THROW(nuc_model_ptr_->transportNuclides(++time_));
+
+  // the outermost cell is offered
+  double outer_mass = radial_fv_ptr_->cell_masses(n_cells_-1)[u235_];
+  pair<IsoVector, double> st = nuc_model_ptr_->source_term_bc();
+  EXPECT_FLOAT_EQ(outer_mass, st.second);
+
+  // and extracting it empties that cell only
+  double inner_mass = radial_fv_ptr_->cell_masses(0)[u235_];
+  EXPECT_NO_THROW(nuc_model_ptr_->extract(st.first.comp(), st.second));
+  EXPECT_FLOAT_EQ(test_size_ - outer_mass, radial_fv_ptr_->contained_mass(time_));
+  EXPECT_NEAR(0, radial_fv_ptr_->cell_masses(n_cells_-1)[u235_], 1e-6*test_size_);
+  EXPECT_FLOAT_EQ(inner_mass, radial_fv_ptr_->cell_masses(0)[u235_]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+INSTANTIATE_TEST_CASE_P(RadialFVNuclideModel, NuclideModelTests, Values(&RadialFVNuclideModelConstructor));
+
@@ -0,0 +1,37 @@
+// RadialFVNuclideTests.h
+#include <gtest/gtest.h>
+
+#include "RadialFVNuclide.h"
+#include "FacilityModelTests.h"
+#include "ModelTests.h"
+#include <string>
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class RadialFVNuclideTest : public ::testing::Test {
+protected:
+  
+  RadialFVNuclidePtr radial_fv_ptr_;
+  RadialFVNuclidePtr default_radial_fv_ptr_;
+  NuclideModelPtr nuc_model_ptr_;
+  NuclideModelPtr default_nuc_model_ptr_;
+  MatDataTablePtr mat_table_;
+  CompMapPtr test_comp_;
+  mat_rsrc_ptr test_mat_;
+  int one_kg_;
+  int u235_;
+  double test_size_;
+  double v_;
+  GeometryPtr geom_;
+  Radius r_four_, r_five_;
+  Length len_five_;
+  point_t origin_;
+  int time_;
+  int n_cells_;
+  double porosity_, rho_; 
+  
+  virtual void SetUp();
+  virtual void TearDown();
+  RadialFVNuclidePtr initNuclideModel();
+  double cells_mass();
+};
+
@@ -0,0 +1,134 @@
+// SqliteDbTests.cpp
+#include <vector>
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include "SqliteDb.h"
+#include "CycException.h"
+
+using namespace std;
+namespace fs = boost::filesystem;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class SqliteDbTest : public ::testing::Test {
+  protected:
+    string path_;
+    SqliteDb* db_;
+
+    virtual void SetUp(){
+      path_ = (fs::temp_directory_path() / 
+          fs::unique_path("cyder-%%%%-%%%%.sqlite")).string();
+      db_ = new SqliteDb(path_);
+      db_->execute("CREATE TABLE clay (elem INTEGER, d REAL, name TEXT)");
+      db_->execute("INSERT INTO clay VALUES (92, 1.5, 'U')");
+      db_->execute("INSERT INTO clay VALUES (82, 2.5, 'Pb')");
+    }
+    virtual void TearDown() {
+      delete db_;
+      fs::remove(path_);
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, query) {
+  vector<StrList> rows = 
+    db_->query("SELECT elem, name FROM clay ORDER BY elem");
+  ASSERT_EQ(2, rows.size());
+  EXPECT_EQ("82", rows[0][0]);
+  EXPECT_EQ("Pb", rows[0][1]);
+  EXPECT_EQ("U", rows[1][1]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, errors) {
+  EXPECT_THROW(db_->query("SELECT nothing FROM nowhere"), CycIOException);
+  EXPECT_THROW(db_->execute("NOT SQL"), CycIOException);
+  // a failure leaves the database usable
+  EXPECT_EQ(2, db_->query("SELECT elem FROM clay").size());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, cursor) {
+  // the columns are read as their own types, and parameters are bound
+  for(int i=0; i < 3; ++i){
+    SqliteCursor cursor(*db_, "SELECT elem, d, name FROM clay WHERE elem=?");
+    cursor.bind(1, 92);
+    EXPECT_EQ(3, cursor.columns());
+    ASSERT_TRUE(cursor.next());
+    EXPECT_EQ(92, cursor.getInt(0));
+    EXPECT_DOUBLE_EQ(1.5, cursor.getDouble(1));
+    EXPECT_EQ("U", cursor.getText(2));
+    EXPECT_FALSE(cursor.next());
+  }
+  {
+    SqliteCursor cursor(*db_, "SELECT elem FROM clay WHERE name=?");
+    cursor.bind(1, string("Pb"));
+    ASSERT_TRUE(cursor.next());
+    EXPECT_EQ(82, cursor.getInt(0));
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, nested_cursors) {
+  // two cursors over the same sql at once don't share a statement
+  string sql = "SELECT elem FROM clay ORDER BY elem";
+  SqliteCursor outer(*db_, sql);
+  ASSERT_TRUE(outer.next());
+  {
+    SqliteCursor inner(*db_, sql);
+    ASSERT_TRUE(inner.next());
+    EXPECT_EQ(82, inner.getInt(0));
+  }
+  EXPECT_EQ(82, outer.getInt(0));
+  ASSERT_TRUE(outer.next());
+  EXPECT_EQ(92, outer.getInt(0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, close_with_cursor) {
+  // closing under an open cursor doesn't throw, and the cursor finishes
+  string sql = "SELECT elem FROM clay ORDER BY elem";
+  {
+    SqliteCursor cursor(*db_, sql);
+    ASSERT_TRUE(cursor.next());
+    EXPECT_NO_THROW(db_->close());
+    ASSERT_TRUE(cursor.next());
+    EXPECT_EQ(92, cursor.getInt(0));
+  }
+  // the database opens again, without the old connection's statements
+  EXPECT_EQ(2, db_->query(sql).size());
+  SqliteCursor cursor(*db_, sql);
+  ASSERT_TRUE(cursor.next());
+  EXPECT_EQ(82, cursor.getInt(0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, insertRows) {
+  vector<vector<double> > rows;
+  for(int i=0; i < 1000; ++i){
+    vector<double> row;
+    row.push_back(i);
+    row.push_back(0.5*i);
+    rows.push_back(row);
+  }
+  EXPECT_NO_THROW(db_->insertRows("INSERT INTO clay (elem, d) VALUES (?,?)", 
+        rows));
+  SqliteCursor cursor(*db_, "SELECT count(*), sum(d) FROM clay");
+  ASSERT_TRUE(cursor.next());
+  EXPECT_EQ(1002, cursor.getInt(0));
+  EXPECT_DOUBLE_EQ(1.5 + 2.5 + 0.5*999*1000/2, cursor.getDouble(1));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(SqliteDbTest, insertRows_rollback) {
+  // if a row can't be inserted, none of them are
+  db_->execute("CREATE TABLE uniq (elem INTEGER PRIMARY KEY)");
+  vector<vector<double> > rows(3, vector<double>(1, 1));
+  rows[0][0] = 7;
+  EXPECT_THROW(db_->insertRows("INSERT INTO uniq VALUES (?)", rows), 
+      CycIOException);
+  EXPECT_EQ(0, db_->query("SELECT elem FROM uniq").size());
+  rows.resize(1);
+  EXPECT_NO_THROW(db_->insertRows("INSERT INTO uniq VALUES (?)", rows));
+  EXPECT_EQ(1, db_->query("SELECT elem FROM uniq").size());
+}
@@ -0,0 +1,164 @@
+// ThermalFieldTests.cpp
+#include <cmath>
+#include <gtest/gtest.h>
+#include <boost/math/constants/constants.hpp>
+
+#include "ThermalField.h"
+#include "DecayOperator.h"
+#include "CycException.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+class ThermalFieldTest : public ::testing::Test {
+  protected:
+    double k_, alpha_, cutoff_, power_, lambda_, month_, pi_;
+    Temp ambient_;
+    int horizon_;
+    point_t origin_;
+
+    virtual void SetUp(){
+      k_ = 2.5;
+      alpha_ = 1e-6;
+      ambient_ = 300;
+      cutoff_ = 50;
+      horizon_ = 1200;
+      power_ = 1000;
+      lambda_ = log(2.0)/(30*365.25*24*3600);
+      month_ = DecayOperator::SECS_PER_TIMESTEP;
+      pi_ = boost::math::constants::pi<double>();
+      origin_ = point(0, 0, 0);
+    }
+    virtual void TearDown() {
+    }
+    point_t point(double x, double y, double z){
+      point_t p = {x, y, z};
+      return p;
+    }
+    // the rise due to a constant source of unit power
+    double steadyRise(double r, int dt){
+      return erfc(r/(2*sqrt(alpha_*dt*month_)))/(4*pi_*k_*r);
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, constructor) {
+  EXPECT_THROW(ThermalField(0, alpha_, ambient_, cutoff_), CycRangeException);
+  EXPECT_THROW(ThermalField(k_, -1, ambient_, cutoff_), CycRangeException);
+  EXPECT_THROW(ThermalField(k_, alpha_, -1, cutoff_), CycRangeException);
+  EXPECT_THROW(ThermalField(k_, alpha_, ambient_, 0), CycRangeException);
+  EXPECT_THROW(ThermalField(k_, alpha_, ambient_, cutoff_, 0), CycRangeException);
+  ThermalField field(k_, alpha_, ambient_, cutoff_, horizon_);
+  EXPECT_EQ(0, field.n_sources());
+  EXPECT_FLOAT_EQ(ambient_, field.temp(origin_, 1, 10));
+  EXPECT_THROW(field.addSource(origin_, -1, 0, 0), CycRangeException);
+  EXPECT_THROW(field.addSource(origin_, 1, -1, 0), CycRangeException);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, constant_source) {
+  ThermalField field(k_, alpha_, ambient_, cutoff_, horizon_);
+  field.addSource(origin_, power_, 0, 0);
+  EXPECT_EQ(1, field.n_sources());
+  EXPECT_EQ(1, field.n_responses());
+  // nothing has happened yet
+  EXPECT_FLOAT_EQ(ambient_, field.temp(point(5, 0, 0), 0, 0));
+  // a source that doesn't decay follows the analytic solution
+  for(int dt=1; dt <= horizon_; dt *= 3){
+    double expected = power_*steadyRise(5, dt);
+    EXPECT_NEAR(expected, field.temp(point(5, 0, 0), 0, dt) - ambient_,
+        0.01*expected);
+  }
+  // and is bounded by the steady state
+  double steady = power_/(4*pi_*k_*5);
+  EXPECT_NEAR(steady, field.peakBound(point(0, 5, 0), 0, 0) - ambient_,
+      0.01*steady);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, decaying_source) {
+  ThermalField field(k_, alpha_, ambient_, cutoff_, horizon_);
+  field.addSource(origin_, power_, lambda_, 0);
+  // a decaying source heats less than a constant one
+  double hot = field.temp(point(2, 0, 0), 0, 12) - ambient_;
+  EXPECT_GT(hot, 0);
+  EXPECT_LT(hot, power_*steadyRise(2, 12));
+  // its peak is behind it eventually, so the bound falls
+  Temp early = field.peakBound(point(2, 0, 0), 0, 0);
+  Temp late = field.peakBound(point(2, 0, 0), 0, horizon_);
+  EXPECT_GT(early, late);
+  EXPECT_GE(early, field.temp(point(2, 0, 0), 0, 12));
+  // and the bound for a new source is its own peak
+  EXPECT_FLOAT_EQ(early - ambient_, field.selfPeak(2, power_, lambda_));
+  EXPECT_EQ(1, field.n_responses());
+  // beyond the horizon it decays with the source
+  double at_horizon = field.temp(point(2, 0, 0), 0, horizon_) - ambient_;
+  double beyond = field.temp(point(2, 0, 0), 0, 2*horizon_) - ambient_;
+  EXPECT_NEAR(at_horizon*exp(-lambda_*horizon_*month_), beyond, 1e-9);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, superposition) {
+  ThermalField one(k_, alpha_, ambient_, cutoff_, horizon_);
+  one.addSource(point(3, 0, 0), power_, lambda_, 0);
+  ThermalField two(k_, alpha_, ambient_, cutoff_, horizon_);
+  two.addSource(point(3, 0, 0), power_, lambda_, 0);
+  two.addSource(point(0, -3, 0), power_, lambda_, 0);
+  double rise = one.temp(origin_, 0, 100) - ambient_;
+  EXPECT_NEAR(2*rise, two.temp(origin_, 0, 100) - ambient_, 1e-9);
+  // a later source that doesn't decay has heated for less time
+  one.addSource(point(0, 0, 3), power_, 0, 0);
+  two.addSource(point(0, 0, 3), power_, 0, 60);
+  double constant = one.temp(origin_, 0, 100) - ambient_ - rise;
+  double later = two.temp(origin_, 0, 100) - ambient_ - 2*rise;
+  EXPECT_GT(later, 0);
+  EXPECT_LT(later, constant);
+  EXPECT_EQ(2, two.n_responses());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, surface) {
+  ThermalField field(k_, alpha_, ambient_, cutoff_, horizon_);
+  field.addSource(origin_, power_, 0, 0);
+  // the temperature at a source is that of the surface around it
+  EXPECT_FLOAT_EQ(field.temp(point(0.5, 0, 0), 0, 24),
+      field.temp(origin_, 0.5, 24));
+  EXPECT_FLOAT_EQ(field.temp(point(0, 1, 0), 0.5, 24),
+      field.temp(point(0, 1, 0), 0, 24));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, cutoff) {
+  ThermalField field(k_, alpha_, ambient_, cutoff_, horizon_);
+  field.addSource(point(cutoff_ + 1, 0, 0), power_, 0, 0);
+  field.addSource(point(-cutoff_ - 1, 0, 0), power_, 0, 0);
+  EXPECT_FLOAT_EQ(ambient_, field.temp(origin_, 0, horizon_));
+  EXPECT_FLOAT_EQ(ambient_, field.peakBound(origin_, 0, 0));
+  field.addSource(point(cutoff_ - 1, 0, 0), power_, 0, 0);
+  EXPECT_GT(field.temp(origin_, 0, horizon_), ambient_);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TEST_F(ThermalFieldTest, cell_list) {
+  // a large repository, with the sources near a point in a field of their
+  // own, gives the same temperature there
+  ThermalField all(k_, alpha_, ambient_, cutoff_, horizon_);
+  ThermalField near(k_, alpha_, ambient_, cutoff_, horizon_);
+  point_t here = point(502, 98, 0);
+  for(int i=0; i < 200; ++i){
+    for(int j=0; j < 50; ++j){
+      point_t src = point(i*6, j*20 - 400, 0);
+      all.addSource(src, power_, lambda_, i);
+      double dx = src.x_ - here.x_;
+      double dy = src.y_ - here.y_;
+      if( dx*dx + dy*dy <= cutoff_*cutoff_ ){
+        near.addSource(src, power_, lambda_, i);
+      }
+    }
+  }
+  EXPECT_EQ(10000, all.n_sources());
+  EXPECT_LT(near.n_sources(), 200);
+  EXPECT_NEAR(near.temp(here, 0.5, 300), all.temp(here, 0.5, 300), 1e-9);
+  EXPECT_NEAR(near.peakBound(here, 0.5, 300), all.peakBound(here, 0.5, 300),
+      1e-9);
+}
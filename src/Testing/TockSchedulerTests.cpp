@@ -0,0 +1,97 @@
+// TockSchedulerTests.cpp
+#include <deque>
+#include <gtest/gtest.h>
+
+#include "Component.h"
+#include "StubNuclide.h"
+#include "StubThermal.h"
+#include "TockScheduler.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+class TockSchedulerTest : public ::testing::Test {
+  protected:
+    TockSchedulerPtr sched_;
+    deque<ComponentPtr> wfs_, wps_, buffers_, empty_;
+    ComponentPtr ff_;
+    int n_wps_, n_wfs_per_wp_, time_;
+
+    virtual void SetUp(){
+      n_wps_ = 5;
+      n_wfs_per_wp_ = 3;
+      time_ = 0;
+      sched_ = TockSchedulerPtr(new TockScheduler());
+
+      // build a small tree, ff <- buffer <- wp <- wf
+      ff_ = node(FF);
+      buffers_.push_back(node(BUFFER));
+      ff_->load(FF, buffers_.back());
+      for(int i=0; i<n_wps_; ++i){
+        wps_.push_back(node(WP));
+        buffers_.back()->load(BUFFER, wps_.back());
+        for(int j=0; j<n_wfs_per_wp_; ++j){
+          wfs_.push_back(node(WF));
+          wps_.back()->load(WP, wfs_.back());
+        }
+      }
+      // an unemplaced waste form, with no parent in the graph
+      wfs_.push_back(node(WF));
+    }
+    virtual void TearDown() {
+    }
+
+    /// a component with an ID of its own
+    ComponentPtr node(ComponentType type){
+      ComponentPtr comp = Component::create();
+      comp->init("node", type, "clay", 1, 2, StubThermal::create(), 
+          StubNuclide::create());
+      return comp;
+    }
+};
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(TockSchedulerTest, rebuild) {
+  EXPECT_TRUE(sched_->dirty());
+  EXPECT_EQ(0, sched_->n_nodes());
+  sched_->rebuild(wfs_, wps_, buffers_, ff_);
+  EXPECT_FALSE(sched_->dirty());
+  EXPECT_EQ(int(wfs_.size() + wps_.size() + buffers_.size() + 1), 
+      sched_->n_nodes());
+  sched_->invalidate();
+  EXPECT_TRUE(sched_->dirty());
+  sched_->rebuild(empty_, empty_, empty_, ComponentPtr());
+  EXPECT_EQ(0, sched_->n_nodes());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(TockSchedulerTest, parents) {
+  sched_->rebuild(wfs_, wps_, buffers_, ff_);
+  const vector<ComponentPtr>& nodes = sched_->nodes();
+  const vector<int>& parents = sched_->parents();
+  // every daughter comes before its parent, and the unemplaced waste form 
+  // and the far field have none
+  for(size_t i=0; i<nodes.size(); ++i){
+    if (parents[i] >= 0){
+      EXPECT_GT(parents[i], int(i));
+      EXPECT_EQ(nodes[i]->parent(), nodes[parents[i]]);
+    }
+  }
+  EXPECT_EQ(-1, parents[wfs_.size() - 1]);
+  EXPECT_EQ(-1, parents.back());
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(TockSchedulerTest, emptyGraph) {
+  sched_->rebuild(empty_, empty_, empty_, ComponentPtr());
+  EXPECT_NO_THROW(sched_->run(&Component::transportHeat, time_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -    
+TEST_F(TockSchedulerTest, runGraph) {
+  sched_->rebuild(wfs_, wps_, buffers_, ff_);
+  // the graph is reused across many timesteps
+  for(int t=0; t<10; ++t){
+    EXPECT_NO_THROW(sched_->run(&Component::transportHeat, t));
+  }
+}
@@ -0,0 +1,198 @@
+/*! \file ThermalField.cpp
+    \brief Implements the ThermalField class used by the Generic Repository
+    \author Kathryn D. Huff
+ */
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <boost/math/constants/constants.hpp>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "DecayOperator.h"
+#include "ThermalField.h"
+
+using namespace std;
+
+const int ThermalField::N_RADII = 64;
+const double ThermalField::MIN_RADIUS = 0.01;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThermalField::ThermalField(double conductivity, double diffusivity,
+    Temp ambient, double cutoff, int horizon) :
+  conductivity_(conductivity),
+  diffusivity_(diffusivity),
+  ambient_(ambient),
+  cutoff_(cutoff),
+  horizon_(horizon)
+{
+  if( conductivity <= 0 || diffusivity <= 0 || ambient < 0 ||
+      cutoff <= MIN_RADIUS || horizon < 1 ){
+    stringstream err;
+    err << "The thermal field needs a positive conductivity (" << conductivity
+      << ") and diffusivity (" << diffusivity << "), an ambient temperature ("
+      << ambient << ") that is not negative, a cutoff (" << cutoff
+      << ") larger than " << MIN_RADIUS << " m and a horizon (" << horizon
+      << ") of at least one timestep.";
+    LOG(LEV_ERROR,"GRThField") << err.str();
+    throw CycRangeException(err.str());
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalField::addSource(point_t pos, Power power, double decay_const,
+    int the_time){
+  if( power < 0 || decay_const < 0 ){
+    stringstream err;
+    err << "A heat source needs a power (" << power << ") and decay constant ("
+      << decay_const << ") that are not negative.";
+    LOG(LEV_ERROR,"GRThField") << err.str();
+    throw CycRangeException(err.str());
+  }
+  int i = power_.size();
+  x_.push_back(pos.x_);
+  y_.push_back(pos.y_);
+  z_.push_back(pos.z_);
+  power_.push_back(power);
+  resp_.push_back(response(decay_const));
+  added_.push_back(the_time);
+  cells_[cellKey(pos)].push_back(i);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::temp(point_t pos, Radius r_self, int the_time){
+  return ambient_ + superpose(pos, r_self, the_time, false);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::peakBound(point_t pos, Radius r_self, int the_time){
+  return ambient_ + superpose(pos, r_self, the_time, true);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Temp ThermalField::selfPeak(Radius r, Power power, double decay_const){
+  if( power <= 0 ){
+    return 0;
+  }
+  const Response& resp = responses_[response(decay_const)];
+  return power*lookup(resp.peaks, resp.decay_const, r, 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int ThermalField::response(double decay_const){
+  int n = responses_.size();
+  for(int i=0; i < n; ++i){
+    if( responses_[i].decay_const == decay_const ){
+      return i;
+    }
+  }
+  responses_.push_back(Response());
+  responses_.back().decay_const = decay_const;
+  tabulate(responses_.back());
+  return responses_.size() - 1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalField::tabulate(Response& resp){
+  int n_cols = horizon_ + 1;
+  double dt = DecayOperator::SECS_PER_TIMESTEP;
+  double decay = exp(-resp.decay_const*dt);
+  double half_decay = exp(-resp.decay_const*dt/2);
+  double log_span = log(cutoff_/MIN_RADIUS);
+  double pi = boost::math::constants::pi<double>();
+  resp.vals.assign(N_RADII*n_cols, 0);
+  resp.peaks.assign(N_RADII*n_cols, 0);
+
+  for(int i=0; i < N_RADII; ++i){
+    double r = MIN_RADIUS*exp(log_span*i/(N_RADII-1));
+    double steady = 1/(4*pi*conductivity_*r);
+    double* vals = &resp.vals[i*n_cols];
+    double* peaks = &resp.peaks[i*n_cols];
+    // the power is taken at the middle of each step, and the response to
+    // the constant power over the step is exact
+    double prev = 0;
+    for(int n=1; n < n_cols; ++n){
+      double next = steady*erfc(r/(2*sqrt(diffusivity_*n*dt)));
+      vals[n] = decay*vals[n-1] + half_decay*(next - prev);
+      prev = next;
+    }
+    // a source that doesn't decay tends to the steady state
+    peaks[horizon_] = (resp.decay_const > 0) ? vals[horizon_] : steady;
+    for(int n=horizon_-1; n >= 0; --n){
+      peaks[n] = max(vals[n], peaks[n+1]);
+    }
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ThermalField::lookup(const vector<double>& table, double decay_const,
+    double r, int dt){
+  int n_cols = horizon_ + 1;
+  double extrap = 1;
+  if( dt < 0 ){
+    dt = 0;
+  } else if( dt > horizon_ ){
+    extrap = exp(-decay_const*(dt - horizon_)*DecayOperator::SECS_PER_TIMESTEP);
+    dt = horizon_;
+  }
+  r = min(max(r, MIN_RADIUS), cutoff_);
+  double u = log(r/MIN_RADIUS)/log(cutoff_/MIN_RADIUS)*(N_RADII-1);
+  int i = min(int(u), N_RADII-2);
+  double w = u - i;
+  // r times the response varies slowly in r, so it is what is interpolated
+  double r_lo = MIN_RADIUS*exp(log(cutoff_/MIN_RADIUS)*i/(N_RADII-1));
+  double r_hi = MIN_RADIUS*exp(log(cutoff_/MIN_RADIUS)*(i+1)/(N_RADII-1));
+  double lo = r_lo*table[i*n_cols + dt];
+  double hi = r_hi*table[(i+1)*n_cols + dt];
+  return extrap*((1-w)*lo + w*hi)/r;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+long long ThermalField::cellKey(point_t pos){
+  return cellKey((long long)floor(pos.x_/cutoff_),
+      (long long)floor(pos.y_/cutoff_), (long long)floor(pos.z_/cutoff_));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+long long ThermalField::cellKey(long long i, long long j, long long k){
+  // 21 bits for each index, offset so that negative indices pack too
+  const long long offset = 1LL << 20;
+  return ((i + offset) << 42) | ((j + offset) << 21) | (k + offset);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+double ThermalField::superpose(point_t pos, Radius r_self, int the_time,
+    bool peaks){
+  long long ci = (long long)floor(pos.x_/cutoff_);
+  long long cj = (long long)floor(pos.y_/cutoff_);
+  long long ck = (long long)floor(pos.z_/cutoff_);
+  double cutoff2 = cutoff_*cutoff_;
+  double sum = 0;
+  for(long long i=ci-1; i <= ci+1; ++i){
+    for(long long j=cj-1; j <= cj+1; ++j){
+      for(long long k=ck-1; k <= ck+1; ++k){
+        map<long long, vector<int> >::const_iterator cell =
+          cells_.find(cellKey(i, j, k));
+        if( cell == cells_.end() ){
+          continue;
+        }
+        const vector<int>& srcs = cell->second;
+        for(size_t s=0; s < srcs.size(); ++s){
+          int src = srcs[s];
+          double dx = x_[src] - pos.x_;
+          double dy = y_[src] - pos.y_;
+          double dz = z_[src] - pos.z_;
+          double d2 = dx*dx + dy*dy + dz*dz;
+          if( d2 > cutoff2 ){
+            continue;
+          }
+          const Response& resp = responses_[resp_[src]];
+          double r = max(sqrt(d2), r_self);
+          sum += power_[src]*lookup(peaks ? resp.peaks : resp.vals,
+              resp.decay_const, r, the_time - added_[src]);
+        }
+      }
+    }
+  }
+  return sum;
+}
@@ -0,0 +1,230 @@
+/*! \file ThermalField.h
+  \brief Declares the ThermalField class used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_THERMALFIELD_H)
+#define _THERMALFIELD_H
+
+#include <map>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "Geometry.h"
+#include "ThermalModel.h"
+
+/// A shared pointer for the ThermalField object
+class ThermalField;
+typedef boost::shared_ptr<ThermalField> ThermalFieldPtr;
+
+/**
+   @brief ThermalField is the temperature field of the host rock around the
+   emplaced waste packages.
+
+   Every emplaced waste form is a point source of heat at the centroid of
+   its waste package, whose power decays exponentially from the power it
+   had when it was emplaced,
+   \f[
+      P(t) = P_0 e^{-\lambda t}.
+   \f]
+   The rock is an infinite conducting medium at the ambient temperature, so
+   the temperature rise at a distance r from a source emplaced a time t ago
+   is the convolution of that power with the Green's function of a point
+   source,
+   \f[
+      \Delta T(r,t) = P_0 \int_0^t e^{-\lambda (t-s)} G(r,s) ds, \qquad
+      \int_0^t G(r,s) ds = \frac{1}{4 \pi k r}
+      \mathrm{erfc}\left(\frac{r}{2\sqrt{\alpha t}}\right).
+   \f]
+   The response to a source of unit power is tabulated once for each decay
+   constant, over the radius (logarithmically, out to the cutoff) and over
+   each timestep out to the horizon, and the temperature anywhere is the
+   ambient temperature plus the superposed, interpolated responses of the
+   sources within the cutoff radius. Later than the horizon, the responses
+   are extrapolated by the decay of the source alone.
+
+   The sources are kept in a cell list, a grid of cubes the size of the
+   cutoff, so that only the sources in the 27 cubes around a point are
+   visited. The cost of a temperature is then set by the density of the
+   sources rather than their number.
+
+   The distance to a source is never taken to be less than the radius of
+   the surface at which the temperature is wanted, the outer radius of a
+   waste package for instance, since a point source has no temperature at
+   its own centre.
+ */
+class ThermalField {
+public:
+  /**
+     Constructor.
+
+     @param conductivity the thermal conductivity of the rock, k [W/m/K]
+     @param diffusivity the thermal diffusivity of the rock, alpha [m^2/s]
+     @param ambient the temperature of the rock far from any source [K]
+     @param cutoff the distance beyond which a source is neglected [m]
+     @param horizon the number of timesteps over which the responses are
+     tabulated
+     @throws CycRangeException if a parameter is not positive
+   */
+  ThermalField(double conductivity, double diffusivity, Temp ambient,
+      double cutoff, int horizon=12000);
+
+  /**
+     adds a heat source
+
+     @param pos the position of the source [m]
+     @param power the power of the source when it is added [W]
+     @param decay_const the decay constant of that power, lambda [1/s]
+     @param the_time the timestep at which the source is added
+     @throws CycRangeException if the power or decay constant is negative
+   */
+  void addSource(point_t pos, Power power, double decay_const, int the_time);
+
+  /**
+     the temperature of the surface of radius r_self around pos
+
+     @param pos the position [m]
+     @param r_self the radius of the surface [m]
+     @param the_time the timestep
+   */
+  Temp temp(point_t pos, Radius r_self, int the_time);
+
+  /**
+     an upper bound on the temperature that the surface of radius r_self
+     around pos will reach from the_time on, due to the sources already
+     added. It is the sum of the largest response of each source from now
+     on, so it falls as the sources cool.
+
+     @param pos the position [m]
+     @param r_self the radius of the surface [m]
+     @param the_time the timestep
+   */
+  Temp peakBound(point_t pos, Radius r_self, int the_time);
+
+  /**
+     the largest temperature rise that a new source would cause at the
+     distance r from itself, ever
+
+     @param r the distance [m]
+     @param power the power of the source when it is added [W]
+     @param decay_const the decay constant of that power, lambda [1/s]
+   */
+  Temp selfPeak(Radius r, Power power, double decay_const);
+
+  /// the number of sources added so far
+  int n_sources() const {return power_.size();};
+
+  /// the number of response tables, one for each decay constant
+  int n_responses() const {return responses_.size();};
+
+  /// the thermal conductivity of the rock [W/m/K]
+  const double conductivity() const {return conductivity_;};
+
+  /// the thermal diffusivity of the rock [m^2/s]
+  const double diffusivity() const {return diffusivity_;};
+
+  /// the temperature of the rock far from any source [K]
+  const Temp ambient() const {return ambient_;};
+
+  /// the distance beyond which a source is neglected [m]
+  const double cutoff() const {return cutoff_;};
+
+  /// the number of timesteps over which the responses are tabulated
+  const int horizon() const {return horizon_;};
+
+  /// the number of radii in a response table
+  static const int N_RADII;
+
+  /// the smallest radius in a response table [m]
+  static const double MIN_RADIUS;
+
+protected:
+  /// the tabulated response to a source of unit power
+  struct Response {
+    /// the decay constant of the source [1/s]
+    double decay_const;
+    /// the response at each radius (row) and timestep (column) [K/W]
+    std::vector<double> vals;
+    /// the largest response at each radius from each timestep on [K/W]
+    std::vector<double> peaks;
+  };
+
+  /**
+     the response table for a decay constant, tabulating it if it is new
+
+     @param decay_const the decay constant [1/s]
+     @return the index of the table in responses_
+   */
+  int response(double decay_const);
+
+  /**
+     tabulates the response to a source of unit power
+
+     @param resp the table, with its decay constant set
+   */
+  void tabulate(Response& resp);
+
+  /**
+     interpolates a table in the radius
+
+     @param table the vals or peaks of a response
+     @param decay_const the decay constant of the response [1/s]
+     @param r the distance [m]
+     @param dt the timesteps since the source was added
+   */
+  double lookup(const std::vector<double>& table, double decay_const,
+      double r, int dt);
+
+  /// the key of the cube of the cell list holding pos
+  long long cellKey(point_t pos);
+
+  /// the key of the cube with the given indices
+  long long cellKey(long long i, long long j, long long k);
+
+  /**
+     sums a table over the sources within the cutoff of pos
+
+     @param peaks true to sum the peaks, false the responses
+   */
+  double superpose(point_t pos, Radius r_self, int the_time, bool peaks);
+
+  /// the thermal conductivity of the rock [W/m/K]
+  double conductivity_;
+
+  /// the thermal diffusivity of the rock [m^2/s]
+  double diffusivity_;
+
+  /// the temperature of the rock far from any source [K]
+  Temp ambient_;
+
+  /// the distance beyond which a source is neglected [m]
+  double cutoff_;
+
+  /// the number of timesteps over which the responses are tabulated
+  int horizon_;
+
+  /// the response tables, one for each decay constant
+  std::vector<Response> responses_;
+
+  /// the x coordinate of each source [m]
+  std::vector<double> x_;
+
+  /// the y coordinate of each source [m]
+  std::vector<double> y_;
+
+  /// the z coordinate of each source [m]
+  std::vector<double> z_;
+
+  /// the power of each source when it was added [W]
+  std::vector<Power> power_;
+
+  /// the index of the response table of each source
+  std::vector<int> resp_;
+
+  /// the timestep at which each source was added
+  std::vector<int> added_;
+
+  /// the sources in each cube of the cell list
+  std::map<long long, std::vector<int> > cells_;
+};
+
+#endif
@@ -0,0 +1,58 @@
+/*! \file ThermalModel.cpp
+    \brief Implements the temperature records shared by the ThermalModel classes
+    \author Kathryn D. Huff
+ */
+#include <sstream>
+
+#include "CycException.h"
+#include "Logger.h"
+#include "ThermalModel.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalModel::set_hist_limit(int hist_limit){
+  if( hist_limit < 0 || hist_limit == 1 ){
+    stringstream msg_ss;
+    msg_ss << "The temperature history limit " << hist_limit 
+      << " must be zero, for no limit, or at least 2.";
+    LOG(LEV_ERROR, "GRThm") << msg_ss.str();
+    throw CycRangeException(msg_ss.str());
+  }
+  hist_limit_ = hist_limit;
+  while( hist_limit_ > 0 && temp_hist_.size() > hist_limit_ ){
+    decimate();
+  }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalModel::record_temp(int the_time, Temp temp){
+  if( n_recorded_ == 0 || temp > peak_temp_ ){
+    peak_temp_ = temp;
+    peak_time_ = the_time;
+  }
+  if( temp > temp_lim_ ){
+    exceedance_ += (n_recorded_ == 0) ? 1 : the_time - last_recorded_;
+  }
+  if( temp_hist_.empty() || 
+      the_time - temp_hist_.rbegin()->first >= hist_stride_ ){
+    temp_hist_[the_time] = temp;
+    while( hist_limit_ > 0 && temp_hist_.size() > hist_limit_ ){
+      decimate();
+    }
+  }
+  last_recorded_ = the_time;
+  ++n_recorded_;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThermalModel::decimate(){
+  TempHist::iterator it = temp_hist_.begin();
+  while( it != temp_hist_.end() ){
+    ++it;
+    if( it != temp_hist_.end() ){
+      temp_hist_.erase(it++);
+    }
+  }
+  hist_stride_ *= 2;
+}
@@ -91,9 +91,8 @@ public:
   virtual std::string name()=0;
 
   /**
-     get the peak Temperature this object will experience during the simulation
-     
-     
+     get the peak Temperature this object has experienced so far in the 
+     simulation
    */
   virtual Temp peak_temp() = 0;
 
@@ -118,13 +117,122 @@ public:
     */
   void set_mat_table(MatDataTablePtr mat_table){mat_table_ = MatDataTablePtr(mat_table);};
 
+  /**
+     set the Temperature, as calculated by the thermal field of the 
+     repository
+
+     @param temp the temperature of this component [K]
+    */
+  void set_temp(Temp temp){temperature_ = temp;};
+
+  /**
+     set the maximum Temperature this component allows, above which the time 
+     is counted as exceedance
+
+     @param temp_lim the temperature limit [K]
+    */
+  void set_temp_lim(Temp temp_lim){temp_lim_ = temp_lim;};
+
+  /// the maximum Temperature this component allows [K]
+  const Temp temp_lim() const {return temp_lim_;};
+
+  /// the timestep at which the peak temperature was recorded
+  const int peak_time() const {return peak_time_;};
+
+  /**
+     the number of timesteps during which the recorded temperature has been 
+     above the temperature limit. Each record counts the time since the 
+     record before it.
+    */
+  const int exceedance() const {return exceedance_;};
+
+  /**
+     set the greatest number of entries in the temperature history, zero to 
+     keep every record. When the history is full, every other entry is 
+     dropped and the interval between the entries doubles, so a history 
+     that is limited covers the whole simulation at a falling resolution.
+
+     @param hist_limit the greatest number of entries, at least 2, or 0
+     @throws CycRangeException if hist_limit is negative or 1
+    */
+  void set_hist_limit(int hist_limit);
+
+  /// the greatest number of entries in the temperature history, 0 if none
+  const int hist_limit() const {return hist_limit_;};
+
+  /// the recorded temperature history, decimated if it is limited
+  const TempHist& temp_hist() const {return temp_hist_;};
+
 protected:
+  /**
+     Default constructor, with nothing recorded
+   */
+  ThermalModel() : 
+    temperature_(0),
+    temp_lim_(373),
+    peak_temp_(0),
+    peak_time_(0),
+    exceedance_(0),
+    last_recorded_(0),
+    n_recorded_(0),
+    hist_limit_(0),
+    hist_stride_(1)
+  {};
+
+  /**
+     records the temperature at a time. The peak and exceedance are kept 
+     with every record, and the history only at its current interval.
+
+     @param the_time the timestep of the record
+     @param temp the temperature [K]
+    */
+  void record_temp(int the_time, Temp temp);
+
+  /**
+     drops every other entry of the temperature history, keeping the first, 
+     and doubles the interval between the entries
+    */
+  void decimate();
+
+  /**
+     copies the temperature limit and history limit of another thermal 
+     model, but none of its records
+    */
+  void copy_limits(const ThermalModel& src){
+    temp_lim_ = src.temp_lim_;
+    hist_limit_ = src.hist_limit_;
+  };
+
   /// The temperature history of this component
   TempHist temp_hist_;
 
   /// The temperature of this component, on average
   Temp temperature_;
 
+  /// The temperature limit of this component [K]
+  Temp temp_lim_;
+
+  /// The peak temperature recorded so far [K]
+  Temp peak_temp_;
+
+  /// The timestep of the peak temperature
+  int peak_time_;
+
+  /// The number of timesteps spent above temp_lim_
+  int exceedance_;
+
+  /// The timestep of the last record
+  int last_recorded_;
+
+  /// The number of records so far, whether they are in the history or not
+  int n_recorded_;
+
+  /// The greatest number of entries in temp_hist_, 0 for no limit
+  size_t hist_limit_;
+
+  /// The smallest interval between entries in temp_hist_ [timesteps]
+  int hist_stride_;
+
   /// A shared pointer to the geometry of this component
   GeometryPtr geom_;
 
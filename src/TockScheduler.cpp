@@ -0,0 +1,58 @@
+/*! \file TockScheduler.cpp
+    \brief Implements the TockScheduler class used by the Generic Repository
+    \author Kathryn D. Huff
+ */
+#include <map>
+
+#include "TockScheduler.h"
+
+using namespace std;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+TockScheduler::TockScheduler() :
+  dirty_(true)
+{
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TockScheduler::rebuild(const deque<ComponentPtr>& waste_forms,
+    const deque<ComponentPtr>& waste_packages,
+    const deque<ComponentPtr>& buffers,
+    ComponentPtr far_field){
+  nodes_.clear();
+  nodes_.insert(nodes_.end(), waste_forms.begin(), waste_forms.end());
+  nodes_.insert(nodes_.end(), waste_packages.begin(), waste_packages.end());
+  nodes_.insert(nodes_.end(), buffers.begin(), buffers.end());
+  if (far_field){
+    nodes_.push_back(far_field);
+  }
+
+  // index the nodes by component ID
+  int n_nodes = nodes_.size();
+  map<int, int> index;
+  for(int i=0; i < n_nodes; ++i){
+    index[nodes_[i]->ID()] = i;
+  }
+
+  parent_.assign(nodes_.size(), -1);
+  map<int, int>::const_iterator found;
+  for(int i=0; i < n_nodes; ++i){
+    ComponentPtr parent = nodes_[i]->parent();
+    if (parent){
+      found = index.find(parent->ID());
+      if (found != index.end()){
+        parent_[i] = found->second;
+      }
+    }
+  }
+  dirty_ = false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TockScheduler::run(ComponentTask task, int the_time){
+  // the layer order puts every daughter before its parent
+  vector<ComponentPtr>::const_iterator iter;
+  for(iter = nodes_.begin(); iter != nodes_.end(); ++iter){
+    ((*iter).get()->*task)(the_time);
+  }
+}
@@ -0,0 +1,94 @@
+/*! \file TockScheduler.h
+  \brief Declares the TockScheduler class used by the Generic Repository
+  \author Kathryn D. Huff
+ */
+#if !defined(_TOCKSCHEDULER_H)
+#define _TOCKSCHEDULER_H
+
+#include <deque>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "Component.h"
+
+/// A pointer to a Component member function that is called once per timestep
+typedef void (Component::*ComponentTask)(int);
+
+/// A shared pointer for the TockScheduler object
+class TockScheduler;
+typedef boost::shared_ptr<TockScheduler> TockSchedulerPtr;
+
+/**
+   @brief TockScheduler passes a Component task through the EBS tree.
+
+   The repository components form a tree (waste forms in waste packages in
+   buffers in the far field), and a component only reads from its own
+   daughters. The scheduler holds that tree as one list of components, in
+   the original layer order (WF, WP, buffer, FF), with the index of the
+   parent of each, so that each task is one loop in place of four and each
+   component runs after all of its daughters.
+
+   The components are run on the calling thread. The models create and
+   absorb materials through cyclus core state that isn't guarded, so they
+   can't be run concurrently.
+
+   The graph is only rebuilt after emplacement changes the tree.
+ */
+class TockScheduler {
+public:
+  /**
+     Constructor, for an empty graph that must be rebuilt before it is run
+   */
+  TockScheduler();
+
+  /**
+     Rebuilds the task graph from the repository components. Components
+     whose parent is not among them (e.g. waste forms in a package that has
+     not yet been emplaced) have no successor.
+
+     @param waste_forms the waste forms, inner -> outer order
+     @param waste_packages the emplaced waste packages
+     @param buffers the buffers
+     @param far_field the far field, may be NULL
+   */
+  void rebuild(const std::deque<ComponentPtr>& waste_forms,
+      const std::deque<ComponentPtr>& waste_packages,
+      const std::deque<ComponentPtr>& buffers,
+      ComponentPtr far_field);
+
+  /**
+     Calls task on every component, each after all of its daughters, in the
+     layer order
+
+     @param task the Component member function to call
+     @param the_time the timestep to pass to the task
+   */
+  void run(ComponentTask task, int the_time);
+
+  /// marks the graph as out of date with the repository tree
+  void invalidate(){dirty_ = true;};
+
+  /// returns true if the graph must be rebuilt before it is run
+  bool dirty() const {return dirty_;};
+
+  /// returns the number of components in the graph
+  int n_nodes() const {return nodes_.size();};
+
+  /// returns the components, in serial layer order (daughters before parents)
+  const std::vector<ComponentPtr>& nodes() const {return nodes_;};
+
+  /// returns the index of the parent of each node, or -1 if it has none
+  const std::vector<int>& parents() const {return parent_;};
+
+protected:
+  /// true if the graph must be rebuilt before it is run
+  bool dirty_;
+
+  /// the components, in serial layer order (daughters before parents)
+  std::vector<ComponentPtr> nodes_;
+
+  /// the index of the parent of each node, or -1 if it is not in the graph
+  std::vector<int> parent_;
+};
+
+#endif